@@ -23,10 +23,24 @@
 
 #include "akushon/action/model/action_name.hpp"
 #include "akushon/action/model/action.hpp"
+#include "akushon/action/model/action_library.hpp"
+#include "akushon/action/model/action_transform.hpp"
+#include "akushon/action/model/joint_group.hpp"
 #include "akushon/action/model/pose.hpp"
 #include "akushon/action/node/action_manager.hpp"
 #include "akushon/action/node/action_node.hpp"
+#include "akushon/action/node/action_team.hpp"
+#include "akushon/action/process/action_evaluator.hpp"
+#include "akushon/action/process/duration_estimator.hpp"
 #include "akushon/action/process/interpolator.hpp"
 #include "akushon/action/process/joint_process.hpp"
+#include "akushon/action/process/teach_recorder.hpp"
+#include "akushon/action/utils/action_cache.hpp"
+#include "akushon/action/utils/action_loader.hpp"
+#include "akushon/action/utils/counting_resource.hpp"
+#include "akushon/action/utils/flight_recorder.hpp"
+#include "akushon/action/utils/input_log.hpp"
+#include "akushon/action/utils/realtime.hpp"
+#include "akushon/action/utils/thread_pool.hpp"
 
 #endif  // AKUSHON__ACTION__ACTION_HPP_
@@ -0,0 +1,159 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef AKUSHON__ACTION__MODEL__ACTION_LIBRARY_HPP_
+#define AKUSHON__ACTION__MODEL__ACTION_LIBRARY_HPP_
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "akushon/action/model/action.hpp"
+#include "akushon/action/model/pose.hpp"
+#include "akushon/action/utils/counting_resource.hpp"
+
+namespace akushon
+{
+
+// Compact storage of a set of actions. Poses of every action are kept in one
+// contiguous table, each with a bitmask of the joints that are present and a
+// reference to a fixed-width row of positions indexed by joint id. Rows are
+// content addressed, so identical poses share one row. Names are interned
+// once.
+// Everything is allocated from a monotonic arena owned by the library, so a
+// loaded generation is released at once when its last user drops it. The
+// arena never frees on its own, a library that keeps being edited grows by
+// every replaced action and widened row, so edits are meant to go into a
+// compact copy that replaces the library, which wastes at most one edit.
+// Removed actions keep their slot so other ids stay valid, and get it back
+// when an action of the same name is added again, so the slots only grow
+// with the number of distinct names.
+class ActionLibrary
+{
+public:
+  static constexpr int MAX_JOINTS = 64;
+
+  using ActionIds = std::pmr::map<std::pmr::string, int, std::less<>>;
+
+  struct MemoryStatus
+  {
+    uint64_t generation;
+    size_t reserved_bytes;
+    size_t used_bytes;
+    size_t allocation_count;
+  };
+
+  struct PoseData
+  {
+    uint64_t joint_mask;
+    float speed;
+    float pause;
+    float via;
+    float duration;
+    uint32_t name_id;
+    uint32_t position_id;
+  };
+
+  struct ActionData
+  {
+    uint32_t name_id;
+    uint32_t next_name_id;
+    int32_t next_action_id;
+    int32_t start_delay;
+    int32_t stop_delay;
+    uint32_t first_pose;
+    uint32_t pose_count;
+    bool is_loaded;
+  };
+
+  explicit ActionLibrary(uint64_t generation = 0);
+
+  // a compact copy in a new arena, every action keeps its id and removed
+  // actions keep an empty slot
+  ActionLibrary(const ActionLibrary & library, uint64_t generation);
+
+  ActionLibrary(const ActionLibrary &) = delete;
+  ActionLibrary & operator=(const ActionLibrary &) = delete;
+
+  // a reserved action keeps its id and is empty until add_action() fills it
+  int reserve_action(const std::string & action_key);
+  int add_action(const std::string & action_key, const Action & action);
+  void remove_action(const std::string & action_key);
+
+  int find_action(const std::string & action_key) const;
+  const ActionIds & get_action_ids() const;
+  int get_action_count() const;
+
+  const ActionData & get_action_data(int action_id) const;
+  const PoseData & get_pose_data(int pose_index) const;
+  const float * get_positions(int pose_index) const;
+  int get_joint_columns() const;
+
+  // poses referenced by the actions against the distinct rows stored
+  int get_pose_count() const;
+  int get_position_count() const;
+
+  const char * get_string(uint32_t string_id) const;
+
+  Action get_action(int action_id) const;
+
+  uint64_t get_generation() const;
+  MemoryStatus get_memory_status() const;
+
+private:
+  int push_empty_action(const std::string & action_key);
+
+  // gives a removed action its slot back, -1 when it was never removed
+  int restore_action(const std::string & action_key);
+
+  uint32_t intern(const std::string & value);
+  uint32_t intern_positions(uint64_t joint_mask, const float * row);
+  void widen(int joint_columns);
+
+  uint64_t generation;
+
+  CountingResource upstream;
+  std::pmr::monotonic_buffer_resource arena;
+  CountingResource resource;
+
+  std::pmr::vector<ActionData> actions;
+  std::pmr::vector<PoseData> poses;
+
+  int joint_columns;
+  std::pmr::vector<float> positions;
+  std::pmr::vector<uint64_t> position_masks;
+  std::pmr::unordered_multimap<uint64_t, uint32_t> position_ids;
+
+  std::pmr::string strings;
+  std::pmr::vector<uint32_t> string_offsets;
+  std::pmr::unordered_multimap<size_t, uint32_t> string_ids;
+
+  ActionIds action_ids;
+  ActionIds removed_ids;
+};
+
+}  // namespace akushon
+
+#endif  // AKUSHON__ACTION__MODEL__ACTION_LIBRARY_HPP_
@@ -21,7 +21,6 @@
 #ifndef AKUSHON__ACTION__MODEL__ACTION_NAME_HPP_
 #define AKUSHON__ACTION__MODEL__ACTION_NAME_HPP_
 
-#include <map>
 #include <string>
 
 namespace akushon
@@ -47,8 +46,6 @@ public:
   static const char * RIGHT_SIDEKICK;
   static const char * KEEPER_SIT;
   static const char * KEEPER_UP;
-
-  static const std::map<std::string, int> map;
 };
 
 }  // namespace akushon
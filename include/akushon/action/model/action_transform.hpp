@@ -0,0 +1,72 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef AKUSHON__ACTION__MODEL__ACTION_TRANSFORM_HPP_
+#define AKUSHON__ACTION__MODEL__ACTION_TRANSFORM_HPP_
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+
+namespace akushon
+{
+
+// A view over a stored action, applied while it is interpolated so the pose
+// data itself is never copied.
+class ActionTransform
+{
+public:
+  static constexpr int MAX_JOINTS = 64;
+
+  // a joint reads the position of its partner with the given sign, joints
+  // that are not listed keep their own position
+  static const std::map<std::string, std::pair<std::string, float>> mirror_map;
+
+  ActionTransform();
+
+  // swaps the left and right side
+  void set_mirror(bool mirror);
+  bool is_mirrored() const;
+
+  // above 1 plays faster, speeds are multiplied and pauses and delays divided
+  void set_time_scale(float time_scale);
+  float get_time_scale() const;
+
+  // added to the position of a joint in every pose, after mirroring
+  void set_offset(uint8_t joint_id, float offset);
+  float get_offset(uint8_t joint_id) const;
+
+  int get_source_id(uint8_t joint_id) const;
+  float get_position(uint8_t joint_id, const float * positions) const;
+
+private:
+  bool mirror;
+  float time_scale;
+
+  std::array<uint8_t, MAX_JOINTS> source_ids;
+  std::array<float, MAX_JOINTS> signs;
+  std::array<float, MAX_JOINTS> offsets;
+};
+
+}  // namespace akushon
+
+#endif  // AKUSHON__ACTION__MODEL__ACTION_TRANSFORM_HPP_
@@ -0,0 +1,49 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef AKUSHON__ACTION__MODEL__JOINT_GROUP_HPP_
+#define AKUSHON__ACTION__MODEL__JOINT_GROUP_HPP_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace akushon
+{
+
+class JointGroup
+{
+public:
+  static const char * HEAD;
+  static const char * ARMS;
+  static const char * LEGS;
+
+  static const std::map<std::string, std::vector<std::string>> map;
+
+  // a bit per joint id, the name is either a group or a single joint, an
+  // unknown name gives an empty mask
+  static uint64_t get_mask(const std::string & name);
+  static uint64_t get_mask(const std::vector<std::string> & names);
+};
+
+}  // namespace akushon
+
+#endif  // AKUSHON__ACTION__MODEL__JOINT_GROUP_HPP_
@@ -40,6 +40,16 @@ public:
   void set_pause(float pause);
   float get_pause() const;
 
+  // above zero the pose is a via point, the next pose starts once every
+  // moving joint is within this distance of its target
+  void set_via(float via);
+  float get_via() const;
+
+  // in milliseconds, every joint arrives together after this time whatever
+  // the control rate, negative to move by speed instead
+  void set_duration(float duration);
+  float get_duration() const;
+
   void set_name(const std::string & pose_name);
   const std::string & get_name() const;
 
@@ -51,6 +61,8 @@ public:
 private:
   float speed;
   float pause;
+  float via;
+  float duration;
 
   std::string name;
 
@@ -21,14 +21,21 @@
 #ifndef AKUSHON__ACTION__NODE__ACTION_MANAGER_HPP_
 #define AKUSHON__ACTION__NODE__ACTION_MANAGER_HPP_
 
+#include <cstdint>
+#include <functional>
 #include <string>
 #include <map>
 #include <vector>
 #include <memory>
+#include <optional>
 
 #include "akushon/action/model/action.hpp"
+#include "akushon/action/model/action_library.hpp"
+#include "akushon/action/model/action_transform.hpp"
 #include "akushon/action/model/pose.hpp"
 #include "akushon/action/process/interpolator.hpp"
+#include "akushon/action/utils/action_loader.hpp"
+#include "akushon/action/utils/flight_recorder.hpp"
 #include "nlohmann/json.hpp"
 #include "tachimawari/joint/model/joint.hpp"
 
@@ -43,25 +50,175 @@ public:
   void insert_action(std::string action_name, const Action & action);
   void delete_action(std::string action_name);
   Action get_action(std::string action_name) const;
+  Action get_action(int action_id) const;
 
+  int get_action_id(const std::string & action_name) const;
+  // empty when no action has the id
+  std::string get_action_name(int action_id) const;
+  // only valid until the next edit or load, hold get_library() to iterate
+  // while loading
+  const ActionLibrary::ActionIds & get_action_ids() const;
+  int get_action_count() const;
+
+  std::shared_ptr<const ActionLibrary> get_library() const;
+
+  // the library is never edited in place, a manager that inserts, deletes or
+  // loads an action afterwards moves to its own copy and the other one keeps
+  // playing what it had
+  void share_library(const ActionManager & action_manager);
+
+  // ids follow the sorted action names in both load modes, so they only
+  // differ when a file can not be parsed, which keeps an empty slot when
+  // indexed but no slot at all when loaded
   void load_config(const std::string & path);
 
+  // only indexes the action files, each action is parsed on its first use or
+  // ahead of time once prefetch() is called
+  void index_config(const std::string & path);
+  void prefetch(const std::vector<std::string> & priority);
+
+  // parses an indexed action and its chain now, true when it is loaded
+  bool ensure_loaded(const std::string & action_name);
+
+  // parses an indexed action and its chain, or all of them, without touching
+  // the library, so it may run beside the motion loop and leave the next use
+  // only the cheap part of loading
+  void preload(const std::string & action_name) const;
+  void preload_all() const;
+
+  // loads every indexed action into a single copy of the library, cheap
+  // once they are preloaded
+  void load_all() const;
+
+  // null unless the actions were indexed
+  std::shared_ptr<const ActionLoader> get_action_loader() const;
+
   Action load_action(const nlohmann::json & action_data, const std::string & action_name) const;
 
-  void start(std::string action_name, const Pose & initial_pose);
-  void start(const Action & action, const Pose & initial_pose);
+  // the same format load_action() reads
+  nlohmann::json dump_action(const Action & action) const;
+
+  // in milliseconds, negative when the action is not found or its chain loops
+  int estimate_duration(int action_id, bool include_chain = false) const;
+  int estimate_duration(int action_id, const Pose & initial_pose, bool include_chain = false) const;
+
+  // the action with every pose timed by a duration_ms that arrives on the same
+  // tick its speed does, an empty action when it is not found
+  Action convert_to_duration(int action_id) const;
+  Action convert_to_duration(int action_id, const Pose & initial_pose) const;
+
+  // the transform applies to every action of the chain
+  void start(
+    std::string action_name, const Pose & initial_pose,
+    const ActionTransform & transform = ActionTransform());
+  void start(
+    int action_id, const Pose & initial_pose,
+    const ActionTransform & transform = ActionTransform());
+  void start(
+    const Action & action, const Pose & initial_pose,
+    const ActionTransform & transform = ActionTransform());
+  // repeats the chain, or the part of it that links back into itself, for
+  // repeat_count iterations or until braked when negative, start() loops such
+  // a chain forever with its delays
+  void start_loop(
+    std::string action_name, const Pose & initial_pose, int repeat_count,
+    bool loop_delays = true, const ActionTransform & transform = ActionTransform());
+  void start_loop(
+    int action_id, const Pose & initial_pose, int repeat_count, bool loop_delays = true,
+    const ActionTransform & transform = ActionTransform());
+  void start_loop(
+    const Action & action, const Pose & initial_pose, int repeat_count,
+    bool loop_delays = true, const ActionTransform & transform = ActionTransform());
+
   void brake();
   void process(int time);
 
+  // queued actions start in order of priority, then of arrival, on the tick
+  // the current one finishes
+  void enqueue(
+    int action_id, int priority = 0, const ActionTransform & transform = ActionTransform());
+  void enqueue(
+    std::shared_ptr<const Action> action, int priority = 0,
+    const ActionTransform & transform = ActionTransform());
+
+  // drops the queue and replaces the current action right away
+  void preempt(
+    int action_id, const Pose & initial_pose,
+    const ActionTransform & transform = ActionTransform());
+  void preempt(
+    const Action & action, const Pose & initial_pose,
+    const ActionTransform & transform = ActionTransform());
+
+  // false when the queue is empty
+  bool start_next(const Pose & initial_pose);
+  void clear_queue();
+  int get_queue_size() const;
+
+  // a layer plays beside the main action on its own joints, taking them over
+  // from the main action and from older layers, a finished layer keeps
+  // holding its joints until they are taken again or the manager brakes
+  void start_layer(
+    int action_id, uint64_t joint_mask, const Pose & initial_pose,
+    const ActionTransform & transform = ActionTransform());
+  void start_layer(
+    const Action & action, uint64_t joint_mask, const Pose & initial_pose,
+    const ActionTransform & transform = ActionTransform());
+  int get_layer_count() const;
+
   bool is_playing() const;
 
+  // process() changes nothing until this time has passed, negative when the
+  // next tick is needed
+  int get_idle_until() const;
+
   std::vector<tachimawari::joint::Joint> get_joints() const;
 
+  FlightRecorder & get_flight_recorder();
+  const FlightRecorder & get_flight_recorder() const;
+
 private:
-  std::map<std::string, Action> actions;
+  struct QueuedAction
+  {
+    // the action is played from the library when it is null
+    int action_id;
+    std::shared_ptr<const Action> action;
+    ActionTransform transform;
+  };
+
+  struct Layer
+  {
+    uint64_t joint_mask;
+    Interpolator interpolator;
+  };
+
+  // loads into a copy of the library that then replaces it, even from const
+  // access as the actions themselves do not change
+  void load_chain(int action_id) const;
+  std::shared_ptr<ActionLibrary> copy_library() const;
+  std::vector<int> get_chain(int action_id);
+  int get_loop_index(const std::vector<int> & action_ids) const;
+  Pose get_current_pose(const Pose & fallback_pose) const;
 
-  std::shared_ptr<Interpolator> interpolator;
+  // drops the finished layers and leaves out the joints of the playing ones
+  Pose get_main_pose(const Pose & initial_pose);
+  Pose get_layer_pose(uint64_t joint_mask, const Pose & initial_pose);
+  void add_layer(uint64_t joint_mask, Interpolator && interpolator);
+
+  Action apply_durations(int action_id, const std::vector<int> & durations) const;
+
+  mutable std::shared_ptr<const ActionLibrary> library;
+  std::shared_ptr<ActionLoader> action_loader;
+
+  std::optional<Interpolator> interpolator;
   bool is_running;
+
+  std::vector<Layer> layers;
+  uint64_t layer_joint_mask;
+
+  // a multimap keeps the arrival order among equal priorities
+  std::multimap<int, QueuedAction, std::greater<int>> action_queue;
+
+  FlightRecorder flight_recorder;
 };
 
 }  // namespace akushon
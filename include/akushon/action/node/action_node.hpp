@@ -21,16 +21,27 @@
 #ifndef AKUSHON__ACTION__NODE__ACTION_NODE_HPP_
 #define AKUSHON__ACTION__NODE__ACTION_NODE_HPP_
 
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "akushon/action/model/action.hpp"
+#include "akushon/action/model/action_transform.hpp"
 #include "akushon/action/model/pose.hpp"
 #include "akushon/action/node/action_manager.hpp"
+#include "akushon/action/process/teach_recorder.hpp"
+#include "akushon/action/utils/action_cache.hpp"
+#include "akushon/action/utils/input_log.hpp"
 #include "akushon_interfaces/msg/run_action.hpp"
 #include "akushon_interfaces/msg/status.hpp"
+#include "akushon_interfaces/srv/get_actions.hpp"
+#include "akushon_interfaces/srv/save_actions.hpp"
 #include "rclcpp/rclcpp.hpp"
 #include "std_msgs/msg/empty.hpp"
+#include "tachimawari/joint/model/joint.hpp"
 #include "tachimawari_interfaces/msg/current_joints.hpp"
 #include "tachimawari_interfaces/msg/set_joints.hpp"
 
@@ -42,28 +53,88 @@ class ActionNode
 public:
   using CurrentJoints = tachimawari_interfaces::msg::CurrentJoints;
   using Empty = std_msgs::msg::Empty;
+  using GetActions = akushon_interfaces::srv::GetActions;
   using RunAction = akushon_interfaces::msg::RunAction;
+  using SaveActions = akushon_interfaces::srv::SaveActions;
   using SetJoints = tachimawari_interfaces::msg::SetJoints;
   using Status = akushon_interfaces::msg::Status;
 
   enum { READY, PLAYING };
 
-  enum { RUN_ACTION_BY_NAME, RUN_ACTION_BY_JSON };
+  enum { RUN_ACTION_BY_NAME, RUN_ACTION_BY_JSON, RUN_ACTION_BY_ID };
 
   static std::string get_node_prefix();
   static std::string run_action_topic();
+  static std::string enqueue_action_topic();
+  static std::string preempt_action_topic();
+  static std::string layer_action_topic();
   static std::string brake_action_topic();
   static std::string status_topic();
+  static std::string dump_flight_record_topic();
+  static std::string cache_status_service();
+  static std::string action_ids_service();
+  static std::string durations_service();
+  static std::string teach_start_service();
+  static std::string teach_stop_service();
 
   explicit ActionNode(
     rclcpp::Node::SharedPtr node, std::shared_ptr<ActionManager> & action_manager);
 
-  bool start(const std::string & action_name);
-  bool start(const Action & action);
+  bool start(
+    const std::string & action_name, const ActionTransform & transform = ActionTransform());
+  bool start(int action_id, const ActionTransform & transform = ActionTransform());
+  bool start(const Action & action, const ActionTransform & transform = ActionTransform());
 
+  // the same entry points the subscriptions use, so a replay goes through them too,
+  // each reads an optional "transform" key of the json, see get_transform()
+  void run_action(const RunAction & message);
+  void brake();
+
+  // the priority is read from a "priority" key of the json, which holds the
+  // action itself for RUN_ACTION_BY_JSON, a higher priority plays earlier
+  void enqueue_action(const RunAction & message);
+
+  // the lane for safety motions, drops the queue and interrupts the current
+  // action from its commanded joints
+  void preempt_action(const RunAction & message);
+
+  // plays on the joints named by a "layer" key of the json, a group such as
+  // "head" or a list of group and joint names, beside the main action
+  void layer_action(const RunAction & message);
+
+  void set_current_joints(const std::vector<tachimawari::joint::Joint> & joints);
+
+  // applies the commands received since the last tick before playing, and
+  // skips the tick rather than waiting when a callback holds the state
   bool update(int time);
 
+  // milliseconds until the next update is needed, negative when idle
+  int get_wakeup_delay(int time) const;
+
+  // called whenever a command may need an update before the wakeup delay
+  void set_wakeup_callback(const std::function<void()> & callback);
+
+  // every input and tick is appended to the log when one is set
+  void set_input_log(std::shared_ptr<InputLog> input_log);
+
+  const ActionCache & get_action_cache() const;
+
 private:
+  // parses the action of a message before it is handed to the tick, from
+  // its file for an indexed library or from the json into the cache, so the
+  // motion loop never waits on a parse
+  void preload(const RunAction & message);
+
+  // queues a command for the next tick, the callbacks never hold the state
+  // while the motion loop needs it
+  void post(const std::function<void()> & command);
+
+  std::shared_ptr<const Action> get_cached_action(const RunAction & message);
+  int get_action_id(const RunAction & message) const;
+  int get_priority(const RunAction & message) const;
+  uint64_t get_joint_mask(const RunAction & message) const;
+  ActionTransform get_transform(const RunAction & message) const;
+
   void publish_joints();
   void publish_status();
 
@@ -72,12 +143,41 @@ private:
 
   std::shared_ptr<ActionManager> action_manager;
 
+  // guards the state shared with the motion loop, which may run on its own
+  // thread apart from the executor, held only briefly outside of update()
+  mutable std::mutex mutex;
+
+  mutable std::mutex command_mutex;
+  std::vector<std::function<void()>> commands;
+
+  mutable std::mutex cache_mutex;
+  ActionCache action_cache;
+
+  std::function<void()> wakeup_callback;
+
+  std::shared_ptr<InputLog> input_log;
+
+  TeachRecorder teach_recorder;
+  double teach_start_time;
+
   rclcpp::Subscription<CurrentJoints>::SharedPtr current_joints_subscriber;
   rclcpp::Publisher<SetJoints>::SharedPtr set_joints_publisher;
 
   rclcpp::Subscription<RunAction>::SharedPtr run_action_subscriber;
+  rclcpp::Subscription<RunAction>::SharedPtr enqueue_action_subscriber;
+  rclcpp::Subscription<RunAction>::SharedPtr preempt_action_subscriber;
+  rclcpp::Subscription<RunAction>::SharedPtr layer_action_subscriber;
   rclcpp::Subscription<Empty>::SharedPtr brake_action_subscriber;
   rclcpp::Publisher<Status>::SharedPtr status_publisher;
+
+  rclcpp::Subscription<Empty>::SharedPtr dump_flight_record_subscriber;
+
+  rclcpp::Service<GetActions>::SharedPtr cache_status_service_server;
+  rclcpp::Service<GetActions>::SharedPtr action_ids_service_server;
+  rclcpp::Service<GetActions>::SharedPtr durations_service_server;
+
+  rclcpp::Service<GetActions>::SharedPtr teach_start_service_server;
+  rclcpp::Service<SaveActions>::SharedPtr teach_stop_service_server;
 };
 
 }  // namespace akushon
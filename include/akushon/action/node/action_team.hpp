@@ -0,0 +1,60 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef AKUSHON__ACTION__NODE__ACTION_TEAM_HPP_
+#define AKUSHON__ACTION__NODE__ACTION_TEAM_HPP_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "akushon/action/node/action_manager.hpp"
+#include "akushon/action/utils/thread_pool.hpp"
+
+namespace akushon
+{
+
+// Serves the action managers of several robots from one process. Every
+// manager plays from the same library while their interpolator states are
+// kept next to each other and stepped together on a shared thread pool.
+class ActionTeam
+{
+public:
+  explicit ActionTeam(int robot_count, int thread_count = 0);
+
+  void load_config(const std::string & path);
+
+  int get_robot_count() const;
+  std::shared_ptr<ActionManager> get_action_manager(int robot_index) const;
+
+  void for_each(const std::function<void(int)> & step);
+  void process(int time);
+
+private:
+  std::shared_ptr<std::vector<ActionManager>> action_managers;
+
+  ThreadPool thread_pool;
+};
+
+}  // namespace akushon
+
+#endif  // AKUSHON__ACTION__NODE__ACTION_TEAM_HPP_
@@ -0,0 +1,81 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef AKUSHON__ACTION__PROCESS__ACTION_EVALUATOR_HPP_
+#define AKUSHON__ACTION__PROCESS__ACTION_EVALUATOR_HPP_
+
+#include <vector>
+
+#include "akushon/action/model/action.hpp"
+#include "akushon/action/model/pose.hpp"
+#include "akushon/action/utils/thread_pool.hpp"
+
+namespace akushon
+{
+
+// Plays variations of an action in virtual time to compare them without
+// running them on the robot.
+class ActionEvaluator
+{
+public:
+  struct Variant
+  {
+    // per pose values, an empty list or a negative value keeps the original
+    std::vector<float> speeds;
+    std::vector<float> pauses;
+
+    int start_delay = -1;
+    int stop_delay = -1;
+  };
+
+  struct Metrics
+  {
+    bool is_finished;
+
+    // in milliseconds, degree per second and degree per second squared
+    int duration;
+    float peak_velocity;
+    float peak_acceleration;
+
+    // largest distance between the final joints and the authored final pose
+    float final_error;
+  };
+
+  explicit ActionEvaluator(
+    const Action & action, const Pose & initial_pose, int time_step = 8, int time_limit = 60000);
+
+  Action apply(const Variant & variant) const;
+
+  Metrics evaluate(const Variant & variant) const;
+  std::vector<Metrics> evaluate(
+    const std::vector<Variant> & variants, ThreadPool & thread_pool) const;
+
+private:
+  Action action;
+  Pose initial_pose;
+
+  int time_step;
+  int time_limit;
+};
+
+}  // namespace akushon
+
+#endif  // AKUSHON__ACTION__PROCESS__ACTION_EVALUATOR_HPP_
@@ -0,0 +1,81 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef AKUSHON__ACTION__PROCESS__DURATION_ESTIMATOR_HPP_
+#define AKUSHON__ACTION__PROCESS__DURATION_ESTIMATOR_HPP_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "akushon/action/model/action_library.hpp"
+#include "akushon/action/model/pose.hpp"
+#include "akushon/action/process/joint_process.hpp"
+
+namespace akushon
+{
+
+// Computes how long the interpolator takes to play an action, in
+// milliseconds, by counting the ticks of each state and stepping only the
+// joints instead of playing it, which includes the blends of via points.
+// Without an initial pose every joint of the first pose is assumed to take
+// every step of its speed, and no via point is taken before they arrive, so
+// only that pose is approximate.
+class DurationEstimator
+{
+public:
+  explicit DurationEstimator(std::shared_ptr<const ActionLibrary> library, int time_step = 8);
+
+  int estimate(int action_id) const;
+  int estimate(int action_id, const Pose & initial_pose) const;
+
+  // negative when the chain of next actions loops back on itself
+  int estimate_chain(int action_id) const;
+  int estimate_chain(int action_id, const Pose & initial_pose) const;
+
+  // the time each pose of the action spends moving, as a duration_ms that
+  // plays the pose in the same number of ticks
+  std::vector<int> estimate_pose_durations(int action_id) const;
+  std::vector<int> estimate_pose_durations(int action_id, const Pose & initial_pose) const;
+
+private:
+  std::vector<int> get_chain(int action_id) const;
+
+  std::vector<int> estimate_pose_durations(int action_id, const Pose * initial_pose) const;
+
+  int estimate(
+    const std::vector<int> & action_ids, const Pose * initial_pose,
+    std::vector<int> * move_ticks_out = nullptr) const;
+  int count_wait_ticks(float duration) const;
+
+  void interpolate(
+    std::vector<JointProcess> & joint_processes, uint64_t & moving_mask, int tick) const;
+  bool is_within(
+    const std::vector<JointProcess> & joint_processes, uint64_t moving_mask,
+    float distance) const;
+
+  std::shared_ptr<const ActionLibrary> library;
+  int time_step;
+};
+
+}  // namespace akushon
+
+#endif  // AKUSHON__ACTION__PROCESS__DURATION_ESTIMATOR_HPP_
@@ -21,11 +21,15 @@
 #ifndef AKUSHON__ACTION__PROCESS__INTERPOLATOR_HPP_
 #define AKUSHON__ACTION__PROCESS__INTERPOLATOR_HPP_
 
-#include <map>
+#include <array>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "akushon/action/model/action.hpp"
+#include "akushon/action/model/action_library.hpp"
+#include "akushon/action/model/action_transform.hpp"
 #include "akushon/action/model/pose.hpp"
 #include "akushon/action/process/joint_process.hpp"
 
@@ -43,23 +47,57 @@ public:
     END
   };
 
-  explicit Interpolator(const std::vector<Action> & actions, const Pose & initial_pose);
+  explicit Interpolator(
+    const std::vector<Action> & actions, const Pose & initial_pose,
+    const ActionTransform & transform = ActionTransform());
+  explicit Interpolator(
+    std::shared_ptr<const ActionLibrary> library, const std::vector<int> & action_ids,
+    const Pose & initial_pose, const ActionTransform & transform = ActionTransform());
+
+  // the actions from loop_index to the end play repeat_count times, or until
+  // braked when it is negative, iterating over the same action ids, the stop
+  // and start delays between iterations are skipped unless loop_delays is set
+  void set_loop(int loop_index, int repeat_count, bool loop_delays = true);
+  int get_remaining_repeats() const;
 
   void process(int time);
   bool is_finished() const;
 
+  // process() changes nothing until this time has passed, negative when the
+  // next tick is needed
+  int get_idle_until() const;
+
   std::vector<tachimawari::joint::Joint> get_joints() const;
+  const std::vector<JointProcess> & get_joint_processes() const;
+
+  int get_state() const;
+  int get_action_id() const;
+  int get_pose_index() const;
 
 private:
-  const Action & get_current_action() const;
-  const Pose & get_current_pose() const;
+  const ActionLibrary::ActionData & get_current_action() const;
+  int get_current_pose_index() const;
+
+  // in milliseconds, after the time scale of the transform
+  float get_start_delay() const;
+  float get_stop_delay() const;
+  float get_pause() const;
 
   bool check_for_next();
-  void next_pose();
+  void next_pose(int time, bool via = false);
+
+  // true once the pose being reached is a via point and every moving joint
+  // is within its distance, unless the next pose asks for a pause first
+  bool check_for_via();
+
+  // false when there is no iteration left
+  bool next_iteration();
 
   void change_state(int state);
 
-  std::vector<Action> actions;
+  std::shared_ptr<const ActionLibrary> library;
+  std::vector<int> action_ids;
+  ActionTransform transform;
 
   int state;
   bool init_state;
@@ -71,7 +109,16 @@ private:
   int current_action_index;
   int current_pose_index;
 
-  std::map<uint8_t, JointProcess> joint_processes;
+  int loop_index;
+  int remaining_repeats;
+  bool loop_delays;
+
+  // sorted by joint id, indexed through joint_indices
+  std::vector<JointProcess> joint_processes;
+  std::array<int, ActionLibrary::MAX_JOINTS> joint_indices;
+
+  // joints that have not reached their target yet, by joint id
+  uint64_t moving_joint_mask;
 };
 
 }  // namespace akushon
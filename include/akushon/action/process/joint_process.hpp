@@ -37,7 +37,19 @@ public:
   void set_target_position(float target_position, float speed = 1.0);
   void set_initial_position(float initial_position);
 
-  void interpolate();
+  // retargets a joint that may still be moving, its step shifts from the
+  // current one to the new one over the ticks it still needed to reach the
+  // previous target, so the velocity stays continuous
+  void set_via_target_position(float target_position, float speed = 1.0);
+
+  float get_remaining_distance() const;
+
+  // moves linearly from the current position and arrives after duration
+  // milliseconds from time, small moves included, zero arrives at once
+  void set_target_duration(float target_position, float duration, int time);
+
+  // time is only used by a move with a duration
+  void interpolate(int time);
 
   bool is_finished() const;
 
@@ -49,6 +61,14 @@ private:
   float target_position;
   float initial_position;
   float additional_position;
+
+  float blend_position;
+  int blend_ticks;
+  int blend_tick;
+
+  bool is_timed;
+  int start_time;
+  float duration;
 };
 
 }  // namespace akushon
@@ -0,0 +1,86 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef AKUSHON__ACTION__PROCESS__TEACH_RECORDER_HPP_
+#define AKUSHON__ACTION__PROCESS__TEACH_RECORDER_HPP_
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "akushon/action/model/action.hpp"
+#include "akushon/action/model/action_library.hpp"
+#include "tachimawari/joint/model/joint.hpp"
+
+namespace akushon
+{
+
+// Records the joints of a robot moved by hand and reduces the recording to
+// the few poses needed to play the same motion back.
+class TeachRecorder
+{
+public:
+  // 8192 samples are a bit more than a minute of feedback at 8 ms
+  explicit TeachRecorder(int capacity = 8192, int time_step = 8);
+
+  // the joints of the first sample are the joints of the recording, every
+  // buffer is allocated here so recording itself never allocates
+  void start(int time, const std::vector<tachimawari::joint::Joint> & joints);
+  void stop();
+
+  // false when not recording or when the capacity is used up
+  bool record(int time, const std::vector<tachimawari::joint::Joint> & joints);
+
+  bool is_recording() const;
+  bool is_full() const;
+  int get_sample_count() const;
+
+  // every pose stays within tolerance degrees of the recording on every
+  // joint, the first pose is reached from the current joints in lead_in ms
+  Action extract(const std::string & action_name, float tolerance, int lead_in = 500) const;
+
+private:
+  float get_position(int sample, int joint) const;
+  // largest distance of a sample from the line between two others
+  float get_deviation(int first, int sample, int last) const;
+  float get_movement(int first, int last) const;
+
+  // largest distance a joint jumps at once because its step is too small
+  float get_jump(int first, int last) const;
+  int get_ticks(int duration) const;
+  int count_move_ticks(int first, int last, float speed) const;
+
+  int capacity;
+  int time_step;
+
+  bool recording;
+  int sample_count;
+
+  std::vector<uint8_t> joint_ids;
+  std::array<int, ActionLibrary::MAX_JOINTS> joint_indices;
+
+  std::vector<int> times;
+  std::vector<float> positions;
+};
+
+}  // namespace akushon
+
+#endif  // AKUSHON__ACTION__PROCESS__TEACH_RECORDER_HPP_
@@ -0,0 +1,77 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef AKUSHON__ACTION__UTILS__ACTION_CACHE_HPP_
+#define AKUSHON__ACTION__UTILS__ACTION_CACHE_HPP_
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "akushon/action/model/action.hpp"
+
+namespace akushon
+{
+
+// Keeps the actions parsed from json payloads, keyed on the name they were
+// loaded under together with the payload, as the name ends up in the action.
+class ActionCache
+{
+public:
+  static uint64_t hash(const std::string & name, const std::string & payload);
+
+  explicit ActionCache(size_t capacity = 16);
+
+  std::shared_ptr<const Action> find(const std::string & name, const std::string & payload);
+  void insert(
+    const std::string & name, const std::string & payload, std::shared_ptr<const Action> action);
+  void clear();
+
+  size_t get_capacity() const;
+  size_t get_size() const;
+
+  uint64_t get_hit_count() const;
+  uint64_t get_miss_count() const;
+
+private:
+  struct Entry
+  {
+    uint64_t key;
+    std::string name;
+    std::string payload;
+    std::shared_ptr<const Action> action;
+  };
+
+  size_t capacity;
+
+  // most recently used entry is kept at the front
+  std::list<Entry> entries;
+  std::unordered_map<uint64_t, std::list<Entry>::iterator> entry_by_key;
+
+  uint64_t hit_count;
+  uint64_t miss_count;
+};
+
+}  // namespace akushon
+
+#endif  // AKUSHON__ACTION__UTILS__ACTION_CACHE_HPP_
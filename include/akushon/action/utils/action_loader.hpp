@@ -0,0 +1,96 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef AKUSHON__ACTION__UTILS__ACTION_LOADER_HPP_
+#define AKUSHON__ACTION__UTILS__ACTION_LOADER_HPP_
+
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+
+namespace akushon
+{
+
+// Indexes the action files of a directory without reading them, and parses
+// them on demand or ahead of time on a background thread.
+class ActionLoader
+{
+public:
+  struct Entry
+  {
+    std::string path;
+    uintmax_t size;
+    std::filesystem::file_time_type modified_time;
+  };
+
+  explicit ActionLoader(const std::string & path);
+  ~ActionLoader();
+
+  ActionLoader(const ActionLoader &) = delete;
+  ActionLoader & operator=(const ActionLoader &) = delete;
+
+  const std::map<std::string, Entry> & get_entries() const;
+
+  // parses the listed actions first, then the rest from the smallest file
+  void prefetch(const std::vector<std::string> & priority);
+
+  // parses an action and the actions it chains into on the calling thread,
+  // or waits for the prefetcher to do so, and keeps them for take()
+  void preload(const std::string & action_name);
+
+  // the parsed file of an action, taken from the prefetcher when it is
+  // already there, otherwise parsed on the calling thread
+  std::optional<nlohmann::json> take(const std::string & action_name);
+
+  int get_parsed_count() const;
+
+private:
+  std::optional<nlohmann::json> parse(const std::string & action_name) const;
+  void work();
+
+  std::map<std::string, Entry> entries;
+
+  std::thread thread;
+
+  mutable std::mutex mutex;
+  std::condition_variable parsed_condition;
+
+  std::vector<std::string> queue;
+  std::set<std::string> claimed_names;
+  // files being parsed outside the lock, by the prefetcher or by preload()
+  std::set<std::string> parsing_names;
+  std::map<std::string, std::optional<nlohmann::json>> parsed_actions;
+  int parsed_count;
+  bool stopping;
+};
+
+}  // namespace akushon
+
+#endif  // AKUSHON__ACTION__UTILS__ACTION_LOADER_HPP_
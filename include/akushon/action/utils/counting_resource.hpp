@@ -0,0 +1,55 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef AKUSHON__ACTION__UTILS__COUNTING_RESOURCE_HPP_
+#define AKUSHON__ACTION__UTILS__COUNTING_RESOURCE_HPP_
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace akushon
+{
+
+// Forwards every request to the upstream resource while keeping track of
+// how much memory has been requested from it.
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+  explicit CountingResource(
+    std::pmr::memory_resource * upstream = std::pmr::new_delete_resource());
+
+  size_t get_allocated_bytes() const;
+  size_t get_allocation_count() const;
+
+private:
+  void * do_allocate(size_t bytes, size_t alignment) override;
+  void do_deallocate(void * pointer, size_t bytes, size_t alignment) override;
+  bool do_is_equal(const std::pmr::memory_resource & other) const noexcept override;
+
+  std::pmr::memory_resource * upstream;
+
+  size_t allocated_bytes;
+  size_t allocation_count;
+};
+
+}  // namespace akushon
+
+#endif  // AKUSHON__ACTION__UTILS__COUNTING_RESOURCE_HPP_
@@ -0,0 +1,112 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef AKUSHON__ACTION__UTILS__FLIGHT_RECORDER_HPP_
+#define AKUSHON__ACTION__UTILS__FLIGHT_RECORDER_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "akushon/action/process/interpolator.hpp"
+
+namespace akushon
+{
+
+// Keeps the last ticks of the interpolator in a fixed-size ring buffer so
+// they can be written to a file after something went wrong.
+class FlightRecorder
+{
+public:
+  static constexpr int MAX_JOINTS = 32;
+
+  // a process keeps its latest dumps only, older ones are removed
+  static constexpr size_t MAX_DUMPS = 8;
+
+  struct Record
+  {
+    int32_t time;
+    int16_t action_id;
+    int16_t pose_index;
+    uint8_t state;
+    uint8_t reserved[3];
+    uint32_t joint_mask;
+    float positions[MAX_JOINTS];
+  };
+
+  struct Header
+  {
+    char magic[4];
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t record_count;
+  };
+
+  // only touches an atomic counter, so it is safe inside a signal handler
+  static void request_dump();
+
+  static std::vector<Record> load(const std::string & path);
+
+  explicit FlightRecorder(size_t capacity = 4096);
+
+  void set_dump_directory(const std::string & dump_directory);
+
+  // a commanded joint moving further than this in one tick is recorded as an
+  // anomaly, zero disables the check
+  void set_jump_threshold(float jump_threshold);
+
+  void record(int time, const Interpolator & interpolator);
+  void mark_anomaly(const std::string & reason);
+
+  // saves the records if a dump was requested or an anomaly was seen, only
+  // the snapshot is taken here and the file is written by a background thread
+  void save_pending();
+  std::string save_in_background(const std::string & reason);
+  std::string save(const std::string & reason);
+  bool dump(const std::string & path) const;
+
+  static bool dump(const std::string & path, const std::vector<Record> & records);
+
+  // unique per process and dump, so recorders sharing a directory do not
+  // overwrite each other
+  std::string get_dump_path(const std::string & reason) const;
+
+  std::vector<Record> get_records() const;
+
+private:
+  static std::atomic<uint64_t> dump_request_count;
+  static std::atomic<uint64_t> dump_sequence;
+
+  std::vector<Record> records;
+  size_t next_index;
+  size_t record_count;
+
+  std::string dump_directory;
+
+  float jump_threshold;
+  std::string pending_reason;
+  uint64_t seen_dump_request_count;
+};
+
+}  // namespace akushon
+
+#endif  // AKUSHON__ACTION__UTILS__FLIGHT_RECORDER_HPP_
@@ -0,0 +1,52 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef AKUSHON__ACTION__UTILS__FNV1A_HPP_
+#define AKUSHON__ACTION__UTILS__FNV1A_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace akushon
+{
+
+// 64-bit FNV-1a, fed incrementally so a key can be built from several
+// fields without joining them first.
+class Fnv1a
+{
+public:
+  static uint64_t hash(const std::string & value);
+
+  Fnv1a();
+
+  void mix(const void * data, size_t size);
+  void mix(const std::string & value);
+
+  uint64_t get_hash() const;
+
+private:
+  uint64_t hash_value;
+};
+
+}  // namespace akushon
+
+#endif  // AKUSHON__ACTION__UTILS__FNV1A_HPP_
@@ -0,0 +1,105 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef AKUSHON__ACTION__UTILS__INPUT_LOG_HPP_
+#define AKUSHON__ACTION__UTILS__INPUT_LOG_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "tachimawari/joint/model/joint.hpp"
+
+namespace akushon
+{
+
+// Appends every input of the action node, together with the ticks it was
+// interleaved with, to a binary file that can be replayed later.
+class InputLog
+{
+public:
+  enum
+  {
+    TICK,
+    RUN_ACTION,
+    BRAKE_ACTION,
+    CURRENT_JOINTS,
+    ENQUEUE_ACTION,
+    PREEMPT_ACTION,
+    LAYER_ACTION
+  };
+
+  struct Event
+  {
+    int type;
+
+    // microseconds since the log was opened
+    int64_t timestamp;
+
+    // TICK
+    int time;
+    uint64_t output_hash;
+
+    // the action events
+    int control_type;
+    std::string action_name;
+    std::string json;
+
+    // CURRENT_JOINTS
+    std::vector<tachimawari::joint::Joint> joints;
+  };
+
+  // zero when there are no joints
+  static uint64_t hash(const std::vector<tachimawari::joint::Joint> & joints);
+
+  static std::vector<Event> load(const std::string & path);
+
+  explicit InputLog(const std::string & path);
+
+  bool is_open() const;
+
+  // outputs are the joints published on this tick, empty when none were
+  void write_tick(int time, const std::vector<tachimawari::joint::Joint> & outputs);
+  // type is one of the action events
+  void write_action(
+    int type, int control_type, const std::string & action_name, const std::string & json);
+  void write_brake_action();
+  void write_current_joints(const std::vector<tachimawari::joint::Joint> & joints);
+
+private:
+  void write_header(uint8_t type);
+  void write_string(const std::string & value);
+
+  template<typename T>
+  void write_value(const T & value)
+  {
+    file.write(reinterpret_cast<const char *>(&value), sizeof(value));
+  }
+
+  std::ofstream file;
+  std::chrono::steady_clock::time_point start_time;
+};
+
+}  // namespace akushon
+
+#endif  // AKUSHON__ACTION__UTILS__INPUT_LOG_HPP_
@@ -0,0 +1,66 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef AKUSHON__ACTION__UTILS__REALTIME_HPP_
+#define AKUSHON__ACTION__UTILS__REALTIME_HPP_
+
+#include <cstddef>
+#include <string>
+
+namespace akushon
+{
+
+// Opt-in hardening of the control process. Most steps need privileges
+// (CAP_IPC_LOCK, CAP_SYS_NICE or a matching rtprio limit), so a failed step
+// is reported rather than treated as an error.
+class Realtime
+{
+public:
+  struct Status
+  {
+    bool memory_locked;
+    size_t locked_bytes;
+
+    // SCHED_FIFO with this priority, zero under any other policy
+    bool fifo_scheduler;
+    int priority;
+
+    // the only cpu the thread may run on, negative when it may run on more
+    int cpu;
+  };
+
+  // locks every current and future page of the process, and keeps freed heap
+  // memory from going back to the system, so the prefaulted pages stay
+  static bool lock_memory(size_t heap_size);
+
+  // for the calling thread, the stack has to be prefaulted from the thread
+  // that runs on it
+  static void prefault_stack(size_t stack_size);
+  static bool set_scheduler(int priority);
+  static bool set_affinity(int cpu);
+
+  // reads back what was actually granted to the calling thread
+  static Status check();
+  static std::string to_string(const Status & status);
+};
+
+}  // namespace akushon
+
+#endif  // AKUSHON__ACTION__UTILS__REALTIME_HPP_
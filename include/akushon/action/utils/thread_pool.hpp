@@ -0,0 +1,80 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#ifndef AKUSHON__ACTION__UTILS__THREAD_POOL_HPP_
+#define AKUSHON__ACTION__UTILS__THREAD_POOL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace akushon
+{
+
+class ThreadPool
+{
+public:
+  // zero thread count uses one worker less than the hardware concurrency,
+  // the thread that calls parallel_for works as well
+  explicit ThreadPool(int thread_count = 0);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool & operator=(const ThreadPool &) = delete;
+
+  int get_thread_count() const;
+
+  // runs job(0) .. job(count - 1) across the pool and waits for all of them
+  void parallel_for(int count, const std::function<void(int)> & job);
+
+  // runs the task on a worker without waiting for it, or right away without
+  // workers, tasks still queued when the pool is destroyed are run first
+  void post(std::function<void()> task);
+
+private:
+  void work();
+  void run_jobs();
+
+  std::vector<std::thread> threads;
+
+  std::mutex mutex;
+  std::condition_variable job_condition;
+  std::condition_variable done_condition;
+
+  const std::function<void(int)> * job;
+  int job_count;
+  std::atomic<int> next_index;
+
+  std::deque<std::function<void()>> tasks;
+
+  uint64_t job_generation;
+  int busy_count;
+  bool stopping;
+};
+
+}  // namespace akushon
+
+#endif  // AKUSHON__ACTION__UTILS__THREAD_POOL_HPP_
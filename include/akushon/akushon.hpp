@@ -22,6 +22,7 @@
 #define AKUSHON__AKUSHON_HPP_
 
 #include "akushon/action/action.hpp"
+#include "akushon/node/akushon_component.hpp"
 #include "akushon/node/akushon_node.hpp"
 
 #endif  // AKUSHON__AKUSHON_HPP_
@@ -45,8 +45,15 @@ private:
 
   Config config_util;
 
+  // get_actions answers with the deduplicated form when set
+  bool deduplicate_actions;
+
   rclcpp::Service<SaveActions>::SharedPtr save_actions_service;
   rclcpp::Service<GetActions>::SharedPtr get_actions_service;
+
+  rclcpp::Service<GetActions>::SharedPtr list_actions_service;
+  rclcpp::Service<SaveActions>::SharedPtr get_action_service;
+  rclcpp::Service<SaveActions>::SharedPtr get_actions_since_service;
 };
 
 }  // namespace akushon
@@ -21,9 +21,13 @@
 #ifndef AKUSHON__CONFIG__UTILS__CONFIG_HPP_
 #define AKUSHON__CONFIG__UTILS__CONFIG_HPP_
 
+#include <cstdint>
 #include <fstream>
+#include <map>
 #include <string>
 
+#include "nlohmann/json.hpp"
+
 namespace akushon
 {
 
@@ -32,11 +36,45 @@ class Config
 public:
   explicit Config(const std::string & path);
 
-  std::string get_config() const;
+  // the deduplicated form moves every distinct set of joints into a shared
+  // "pose_pool" keyed by its hash and lists the actions under "actions", with
+  // each pose referring to its joints by that key
+  std::string get_config(bool deduplicate = false) const;
+
+  // accepts both the plain and the deduplicated form
   void save_config(const std::string & actions_data);
 
+  static nlohmann::json deduplicate(const nlohmann::json & actions_list);
+  // an action referring to a pose missing from the pool is left out
+  static nlohmann::json expand(const nlohmann::json & deduplicated_list);
+
+  // the version of an action is the modification time of its file, so edits
+  // made outside of save_config() are seen as well
+  struct ActionInfo
+  {
+    uintmax_t size;
+    int pose_count;
+    int64_t version;
+  };
+
+  // files are only parsed again when their size or version changed
+  std::map<std::string, ActionInfo> list_actions();
+
+  // null when the action does not exist, can not be parsed or its name is
+  // not a plain file name inside the action directory
+  nlohmann::json get_action(const std::string & action_name) const;
+
+  // every action with a newer version, the latest version and the names of
+  // all actions so removed ones can be dropped as well
+  nlohmann::json get_actions_since(int64_t version);
+
 private:
+  static int64_t get_version(const std::string & file_name);
+  static bool is_valid_action_name(const std::string & action_name);
+
   std::string path;
+
+  std::map<std::string, ActionInfo> action_infos;
 };
 
 }  // namespace akushon
@@ -0,0 +1,49 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef AKUSHON__CORE_HPP_
+#define AKUSHON__CORE_HPP_
+
+// everything in akushon_core, none of these pull in rclcpp
+
+#include "akushon/action/model/action_name.hpp"
+#include "akushon/action/model/action.hpp"
+#include "akushon/action/model/action_library.hpp"
+#include "akushon/action/model/action_transform.hpp"
+#include "akushon/action/model/joint_group.hpp"
+#include "akushon/action/model/pose.hpp"
+#include "akushon/action/node/action_manager.hpp"
+#include "akushon/action/node/action_team.hpp"
+#include "akushon/action/process/action_evaluator.hpp"
+#include "akushon/action/process/duration_estimator.hpp"
+#include "akushon/action/process/interpolator.hpp"
+#include "akushon/action/process/joint_process.hpp"
+#include "akushon/action/process/teach_recorder.hpp"
+#include "akushon/action/utils/action_cache.hpp"
+#include "akushon/action/utils/action_loader.hpp"
+#include "akushon/action/utils/counting_resource.hpp"
+#include "akushon/action/utils/flight_recorder.hpp"
+#include "akushon/action/utils/fnv1a.hpp"
+#include "akushon/action/utils/input_log.hpp"
+#include "akushon/action/utils/realtime.hpp"
+#include "akushon/action/utils/thread_pool.hpp"
+#include "akushon/config/utils/config.hpp"
+
+#endif  // AKUSHON__CORE_HPP_
@@ -0,0 +1,50 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef AKUSHON__NODE__AKUSHON_COMPONENT_HPP_
+#define AKUSHON__NODE__AKUSHON_COMPONENT_HPP_
+
+#include <memory>
+
+#include "akushon/node/akushon_node.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+namespace akushon
+{
+
+// AkushonNode packaged as an rclcpp component. Loaded into the container of
+// tachimawari, joint commands travel through intra-process communication
+// without serialization. The action path is read from the "path" parameter.
+class AkushonComponent
+{
+public:
+  explicit AkushonComponent(const rclcpp::NodeOptions & options);
+
+  rclcpp::node_interfaces::NodeBaseInterface::SharedPtr get_node_base_interface() const;
+
+private:
+  rclcpp::Node::SharedPtr node;
+
+  std::shared_ptr<AkushonNode> akushon_node;
+};
+
+}  // namespace akushon
+
+#endif  // AKUSHON__NODE__AKUSHON_COMPONENT_HPP_
@@ -21,8 +21,10 @@
 #ifndef AKUSHON__NODE__AKUSHON_NODE_HPP_
 #define AKUSHON__NODE__AKUSHON_NODE_HPP_
 
+#include <atomic>
 #include <memory>
 #include <string>
+#include <thread>
 
 #include "akushon/action/node/action_manager.hpp"
 #include "akushon/action/node/action_node.hpp"
@@ -31,6 +33,8 @@
 #include "akushon_interfaces/srv/get_actions.hpp"
 #include "rclcpp/rclcpp.hpp"
 #include "rclcpp_action/rclcpp_action.hpp"
+#include "rosgraph_msgs/msg/clock.hpp"
+#include "std_msgs/msg/empty.hpp"
 
 namespace akushon
 {
@@ -38,17 +42,56 @@ namespace akushon
 class AkushonNode
 {
 public:
+  using Clock = rosgraph_msgs::msg::Clock;
+  using Empty = std_msgs::msg::Empty;
+
+  static std::string step_topic();
+
   explicit AkushonNode(rclcpp::Node::SharedPtr node);
+  ~AkushonNode();
+
+  // loads the actions, or only indexes them when the lazy_load parameter is
+  // set, and prints the state of the library
+  std::shared_ptr<ActionManager> load_action_manager(const std::string & path);
 
   void run_action_manager(std::shared_ptr<ActionManager> action_manager);
 
   void run_config_service(const std::string & path);
 
 private:
+  void update();
+  void update(int time);
+  void wakeup();
+
+  // the motion loop of the real-time mode, on its own thread away from the
+  // executor, sleeping to absolute 8 ms deadlines
+  void run_motion_loop();
+
   double start_time;
   rclcpp::Node::SharedPtr node;
   rclcpp::TimerBase::SharedPtr node_timer;
 
+  // when enabled, the timer is stopped while there is nothing to update
+  bool tickless;
+  rclcpp::TimerBase::SharedPtr wakeup_timer;
+
+  // in lockstep the timer is replaced by one update per clock or step message
+  std::string lockstep;
+  int step_count;
+  rclcpp::Subscription<Clock>::SharedPtr clock_subscriber;
+  rclcpp::Subscription<Empty>::SharedPtr step_subscriber;
+
+  // opt-in, replaces the timer with the motion thread, a negative cpu leaves
+  // the thread unpinned
+  bool realtime;
+  int realtime_priority;
+  int realtime_cpu;
+  std::atomic<bool> motion_running;
+  std::thread motion_thread;
+
+  // inputs are recorded to this file for the replay tool when it is set
+  std::string input_log_path;
+
   std::shared_ptr<ActionNode> action_node;
 
   std::shared_ptr<ConfigNode> config_node;
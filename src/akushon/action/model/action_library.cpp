@@ -0,0 +1,415 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "akushon/action/model/action_library.hpp"
+
+#include "akushon/action/model/action.hpp"
+#include "akushon/action/model/pose.hpp"
+#include "akushon/action/utils/fnv1a.hpp"
+#include "tachimawari/joint/model/joint.hpp"
+
+namespace akushon
+{
+
+ActionLibrary::ActionLibrary(uint64_t generation)
+: generation(generation), upstream(), arena(&upstream), resource(&arena),
+  actions(&resource), poses(&resource), joint_columns(0), positions(&resource),
+  position_masks(&resource), position_ids(&resource), strings(&resource),
+  string_offsets(&resource), string_ids(&resource), action_ids(&resource),
+  removed_ids(&resource)
+{
+}
+
+ActionLibrary::ActionLibrary(const ActionLibrary & library, uint64_t generation)
+: ActionLibrary(generation)
+{
+  std::vector<const std::pmr::string *> action_keys(library.actions.size(), nullptr);
+  for (const auto & [action_key, action_id] : library.action_ids) {
+    action_keys[action_id] = &action_key;
+  }
+
+  std::vector<const std::pmr::string *> removed_keys(library.actions.size(), nullptr);
+  for (const auto & [action_key, action_id] : library.removed_ids) {
+    removed_keys[action_id] = &action_key;
+  }
+
+  // every row is as wide as the widest one from the start, so no row has to
+  // be widened again while copying
+  widen(library.joint_columns);
+
+  for (size_t action_id = 0; action_id < library.actions.size(); ++action_id) {
+    if (!action_keys[action_id]) {
+      push_empty_action("");
+
+      if (removed_keys[action_id]) {
+        removed_ids.emplace(*removed_keys[action_id], action_id);
+      }
+
+      continue;
+    }
+
+    std::string action_key(*action_keys[action_id]);
+    if (library.actions[action_id].is_loaded) {
+      add_action(action_key, library.get_action(action_id));
+    } else {
+      reserve_action(action_key);
+    }
+  }
+}
+
+int ActionLibrary::reserve_action(const std::string & action_key)
+{
+  int action_id = find_action(action_key);
+  if (action_id >= 0) {
+    return action_id;
+  }
+
+  action_id = restore_action(action_key);
+  if (action_id >= 0) {
+    return action_id;
+  }
+
+  action_id = push_empty_action(action_key);
+  action_ids.emplace(action_key, action_id);
+
+  return action_id;
+}
+
+int ActionLibrary::add_action(const std::string & action_key, const Action & action)
+{
+  int action_id = find_action(action_key);
+  if (action_id >= 0 && actions[action_id].is_loaded) {
+    return -1;
+  }
+
+  if (action_id < 0) {
+    action_id = restore_action(action_key);
+  }
+
+  bool is_reserved = (action_id >= 0);
+  if (!is_reserved) {
+    action_id = actions.size();
+  }
+
+  ActionData action_data;
+  action_data.name_id = intern(action.get_name());
+  action_data.next_name_id = intern(action.get_next_action());
+  action_data.next_action_id = find_action(action.get_next_action());
+  action_data.start_delay = action.get_start_delay();
+  action_data.stop_delay = action.get_stop_delay();
+  action_data.first_pose = poses.size();
+  action_data.pose_count = action.get_pose_count();
+  action_data.is_loaded = true;
+
+  for (const auto & pose : action.get_poses()) {
+    PoseData pose_data;
+    pose_data.joint_mask = 0;
+    pose_data.speed = pose.get_speed();
+    pose_data.pause = pose.get_pause();
+    pose_data.via = pose.get_via();
+    pose_data.duration = pose.get_duration();
+    pose_data.name_id = intern(pose.get_name());
+
+    for (const auto & joint : pose.get_joints()) {
+      if (joint.get_id() >= MAX_JOINTS) {
+        throw std::out_of_range("joint id " + std::to_string(joint.get_id()) + " is not supported");
+      }
+
+      widen(joint.get_id() + 1);
+    }
+
+    float row[MAX_JOINTS] = {};
+    for (const auto & joint : pose.get_joints()) {
+      pose_data.joint_mask |= (uint64_t(1) << joint.get_id());
+      row[joint.get_id()] = joint.get_position();
+    }
+
+    pose_data.position_id = intern_positions(pose_data.joint_mask, row);
+
+    poses.push_back(pose_data);
+  }
+
+  if (is_reserved) {
+    actions[action_id] = action_data;
+  } else {
+    actions.push_back(action_data);
+    action_ids.emplace(action_key, action_id);
+  }
+
+  // link the actions that were loaded before their next action
+  uint32_t key_id = intern(action_key);
+  for (auto & other : actions) {
+    if (other.next_name_id == key_id) {
+      other.next_action_id = action_id;
+    }
+  }
+
+  return action_id;
+}
+
+void ActionLibrary::remove_action(const std::string & action_key)
+{
+  auto it = action_ids.find(std::string_view(action_key));
+  if (it == action_ids.end()) {
+    return;
+  }
+
+  // the slot is kept empty so the ids of the other actions stay valid
+  auto & action_data = actions[it->second];
+  action_data.pose_count = 0;
+  action_data.next_action_id = -1;
+  action_data.is_loaded = false;
+
+  for (auto & other : actions) {
+    if (other.next_action_id == it->second) {
+      other.next_action_id = -1;
+    }
+  }
+
+  removed_ids.emplace(it->first, it->second);
+  action_ids.erase(it);
+}
+
+int ActionLibrary::find_action(const std::string & action_key) const
+{
+  auto it = action_ids.find(std::string_view(action_key));
+  if (it != action_ids.end()) {
+    return it->second;
+  }
+
+  return -1;
+}
+
+const ActionLibrary::ActionIds & ActionLibrary::get_action_ids() const
+{
+  return action_ids;
+}
+
+int ActionLibrary::get_action_count() const
+{
+  return actions.size();
+}
+
+const ActionLibrary::ActionData & ActionLibrary::get_action_data(int action_id) const
+{
+  return actions.at(action_id);
+}
+
+const ActionLibrary::PoseData & ActionLibrary::get_pose_data(int pose_index) const
+{
+  return poses[pose_index];
+}
+
+const float * ActionLibrary::get_positions(int pose_index) const
+{
+  return positions.data() + poses[pose_index].position_id * joint_columns;
+}
+
+int ActionLibrary::get_joint_columns() const
+{
+  return joint_columns;
+}
+
+int ActionLibrary::get_pose_count() const
+{
+  return poses.size();
+}
+
+int ActionLibrary::get_position_count() const
+{
+  return position_masks.size();
+}
+
+const char * ActionLibrary::get_string(uint32_t string_id) const
+{
+  return strings.data() + string_offsets[string_id];
+}
+
+Action ActionLibrary::get_action(int action_id) const
+{
+  const auto & action_data = actions.at(action_id);
+
+  Action action(get_string(action_data.name_id));
+  action.set_next_action(get_string(action_data.next_name_id));
+  action.set_start_delay(action_data.start_delay);
+  action.set_stop_delay(action_data.stop_delay);
+
+  for (uint32_t i = 0; i < action_data.pose_count; ++i) {
+    int pose_index = action_data.first_pose + i;
+    const auto & pose_data = poses[pose_index];
+    const float * pose_positions = get_positions(pose_index);
+
+    std::vector<tachimawari::joint::Joint> joints;
+    for (int id = 0; id < joint_columns; ++id) {
+      if (pose_data.joint_mask & (uint64_t(1) << id)) {
+        joints.push_back(tachimawari::joint::Joint(id, pose_positions[id]));
+      }
+    }
+
+    Pose pose(get_string(pose_data.name_id));
+    pose.set_speed(pose_data.speed);
+    pose.set_pause(pose_data.pause);
+    pose.set_via(pose_data.via);
+    pose.set_duration(pose_data.duration);
+    pose.set_joints(joints);
+
+    action.add_pose(pose);
+  }
+
+  return action;
+}
+
+uint64_t ActionLibrary::get_generation() const
+{
+  return generation;
+}
+
+ActionLibrary::MemoryStatus ActionLibrary::get_memory_status() const
+{
+  MemoryStatus memory_status;
+  memory_status.generation = generation;
+  memory_status.reserved_bytes = upstream.get_allocated_bytes();
+  memory_status.used_bytes = resource.get_allocated_bytes();
+  memory_status.allocation_count = resource.get_allocation_count();
+
+  return memory_status;
+}
+
+int ActionLibrary::push_empty_action(const std::string & action_key)
+{
+  ActionData action_data;
+  action_data.name_id = intern(action_key);
+  action_data.next_name_id = intern("");
+  action_data.next_action_id = -1;
+  action_data.start_delay = 0;
+  action_data.stop_delay = 0;
+  action_data.first_pose = poses.size();
+  action_data.pose_count = 0;
+  action_data.is_loaded = false;
+
+  actions.push_back(action_data);
+
+  return actions.size() - 1;
+}
+
+int ActionLibrary::restore_action(const std::string & action_key)
+{
+  auto it = removed_ids.find(std::string_view(action_key));
+  if (it == removed_ids.end()) {
+    return -1;
+  }
+
+  int action_id = it->second;
+  action_ids.emplace(action_key, action_id);
+  removed_ids.erase(it);
+
+  return action_id;
+}
+
+uint32_t ActionLibrary::intern(const std::string & value)
+{
+  size_t key = std::hash<std::string>()(value);
+
+  auto range = string_ids.equal_range(key);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (value == get_string(it->second)) {
+      return it->second;
+    }
+  }
+
+  uint32_t string_id = string_offsets.size();
+  string_offsets.push_back(strings.size());
+  strings.append(value.c_str(), value.size() + 1);
+  string_ids.insert({key, string_id});
+
+  return string_id;
+}
+
+uint32_t ActionLibrary::intern_positions(uint64_t joint_mask, const float * row)
+{
+  // FNV-1a over the mask and the present positions, -0.0 is hashed as 0.0 as
+  // they compare equal
+  Fnv1a fnv1a;
+  fnv1a.mix(&joint_mask, sizeof(joint_mask));
+  for (int id = 0; id < joint_columns; ++id) {
+    if (joint_mask & (uint64_t(1) << id)) {
+      float position = (row[id] == 0.0f) ? 0.0f : row[id];
+      fnv1a.mix(&position, sizeof(position));
+    }
+  }
+
+  uint64_t key = fnv1a.get_hash();
+
+  auto range = position_ids.equal_range(key);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (position_masks[it->second] != joint_mask) {
+      continue;
+    }
+
+    const float * other = positions.data() + it->second * joint_columns;
+
+    bool is_equal = true;
+    for (int id = 0; id < joint_columns && is_equal; ++id) {
+      is_equal = !(joint_mask & (uint64_t(1) << id)) || other[id] == row[id];
+    }
+
+    if (is_equal) {
+      return it->second;
+    }
+  }
+
+  uint32_t position_id = position_masks.size();
+  positions.insert(positions.end(), row, row + joint_columns);
+  position_masks.push_back(joint_mask);
+  position_ids.insert({key, position_id});
+
+  return position_id;
+}
+
+void ActionLibrary::widen(int joint_columns)
+{
+  if (joint_columns <= this->joint_columns) {
+    return;
+  }
+
+  std::pmr::vector<float> widened_positions(
+    position_masks.size() * joint_columns, 0.0, &resource);
+  for (size_t i = 0; i < position_masks.size(); ++i) {
+    for (int id = 0; id < this->joint_columns; ++id) {
+      widened_positions[i * joint_columns + id] = positions[i * this->joint_columns + id];
+    }
+  }
+
+  positions.swap(widened_positions);
+  this->joint_columns = joint_columns;
+}
+
+}  // namespace akushon
@@ -18,7 +18,6 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
-#include <map>
 #include <string>
 
 #include "akushon/action/model/action_name.hpp"
@@ -27,21 +26,12 @@
 namespace akushon
 {
 
-const std::map<std::string, int> ActionName::map = {
-  {"init", 0},
-  {"walk_ready", 1},
-  {"sit_down", 2},
-  {"forward_up", 3},
-  {"backward_up", 4},
-  {"leftward_up", 5}
-};
-
 const char * ActionName::INIT = "init";
 const char * ActionName::WALKREADY = "walk_ready";
 const char * ActionName::SIT_DOWN = "sit_down";
 const char * ActionName::FORWARD_UP = "forward_up";
 const char * ActionName::BACKWARD_UP = "backward_up";
-const char * ActionName::LEFTWARD_UP = "leftward_ups";
+const char * ActionName::LEFTWARD_UP = "leftward_up";
 const char * ActionName::RIGHTWARD_UP = "rightward_up";
 const char * ActionName::RIGHT_KICK = "right_kick";
 const char * ActionName::LEFT_KICK = "left_kick";
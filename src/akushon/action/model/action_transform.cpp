@@ -0,0 +1,134 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include <map>
+#include <string>
+#include <utility>
+
+#include "akushon/action/model/action_transform.hpp"
+
+#include "tachimawari/joint/model/joint_id.hpp"
+
+namespace akushon
+{
+
+// left and right joints are mounted the other way around, so a mirrored
+// position changes sign, as does the yaw of the neck
+const std::map<std::string, std::pair<std::string, float>> ActionTransform::mirror_map = {
+  {"neck_yaw", {"neck_yaw", -1.0}},
+  {"left_shoulder_pitch", {"right_shoulder_pitch", -1.0}},
+  {"right_shoulder_pitch", {"left_shoulder_pitch", -1.0}},
+  {"left_shoulder_roll", {"right_shoulder_roll", -1.0}},
+  {"right_shoulder_roll", {"left_shoulder_roll", -1.0}},
+  {"left_elbow", {"right_elbow", -1.0}},
+  {"right_elbow", {"left_elbow", -1.0}},
+  {"left_hip_yaw", {"right_hip_yaw", -1.0}},
+  {"right_hip_yaw", {"left_hip_yaw", -1.0}},
+  {"left_hip_roll", {"right_hip_roll", -1.0}},
+  {"right_hip_roll", {"left_hip_roll", -1.0}},
+  {"left_hip_pitch", {"right_hip_pitch", -1.0}},
+  {"right_hip_pitch", {"left_hip_pitch", -1.0}},
+  {"left_knee", {"right_knee", -1.0}},
+  {"right_knee", {"left_knee", -1.0}},
+  {"left_ankle_pitch", {"right_ankle_pitch", -1.0}},
+  {"right_ankle_pitch", {"left_ankle_pitch", -1.0}},
+  {"left_ankle_roll", {"right_ankle_roll", -1.0}},
+  {"right_ankle_roll", {"left_ankle_roll", -1.0}}
+};
+
+ActionTransform::ActionTransform()
+: mirror(false), time_scale(1.0)
+{
+  for (int id = 0; id < MAX_JOINTS; ++id) {
+    source_ids[id] = id;
+  }
+
+  signs.fill(1.0);
+  offsets.fill(0.0);
+}
+
+void ActionTransform::set_mirror(bool mirror)
+{
+  using tachimawari::joint::JointId;
+
+  this->mirror = mirror;
+
+  for (int id = 0; id < MAX_JOINTS; ++id) {
+    source_ids[id] = id;
+  }
+
+  signs.fill(1.0);
+
+  if (!mirror) {
+    return;
+  }
+
+  for (const auto & [joint_name, source] : mirror_map) {
+    auto joint_id = JointId::by_name.find(joint_name);
+    auto source_id = JointId::by_name.find(source.first);
+    if (joint_id == JointId::by_name.end() || source_id == JointId::by_name.end() ||
+      joint_id->second >= MAX_JOINTS || source_id->second >= MAX_JOINTS)
+    {
+      continue;
+    }
+
+    source_ids[joint_id->second] = source_id->second;
+    signs[joint_id->second] = source.second;
+  }
+}
+
+bool ActionTransform::is_mirrored() const
+{
+  return mirror;
+}
+
+void ActionTransform::set_time_scale(float time_scale)
+{
+  this->time_scale = (time_scale > 0.0) ? time_scale : 1.0;
+}
+
+float ActionTransform::get_time_scale() const
+{
+  return time_scale;
+}
+
+void ActionTransform::set_offset(uint8_t joint_id, float offset)
+{
+  if (joint_id < MAX_JOINTS) {
+    offsets[joint_id] = offset;
+  }
+}
+
+float ActionTransform::get_offset(uint8_t joint_id) const
+{
+  return (joint_id < MAX_JOINTS) ? offsets[joint_id] : 0.0;
+}
+
+int ActionTransform::get_source_id(uint8_t joint_id) const
+{
+  return (joint_id < MAX_JOINTS) ? source_ids[joint_id] : joint_id;
+}
+
+float ActionTransform::get_position(uint8_t joint_id, const float * positions) const
+{
+  return positions[source_ids[joint_id]] * signs[joint_id] + offsets[joint_id];
+}
+
+}  // namespace akushon
@@ -0,0 +1,78 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "akushon/action/model/joint_group.hpp"
+
+#include "tachimawari/joint/model/joint_id.hpp"
+
+namespace akushon
+{
+
+const std::map<std::string, std::vector<std::string>> JointGroup::map = {
+  {"head", {"neck_yaw", "neck_pitch"}},
+  {"arms", {
+      "left_shoulder_pitch", "left_shoulder_roll", "left_elbow",
+      "right_shoulder_pitch", "right_shoulder_roll", "right_elbow"}},
+  {"legs", {
+      "left_hip_yaw", "left_hip_roll", "left_hip_pitch", "left_knee",
+      "left_ankle_pitch", "left_ankle_roll",
+      "right_hip_yaw", "right_hip_roll", "right_hip_pitch", "right_knee",
+      "right_ankle_pitch", "right_ankle_roll"}}
+};
+
+const char * JointGroup::HEAD = "head";
+const char * JointGroup::ARMS = "arms";
+const char * JointGroup::LEGS = "legs";
+
+uint64_t JointGroup::get_mask(const std::string & name)
+{
+  using tachimawari::joint::JointId;
+
+  auto group = map.find(name);
+  if (group == map.end()) {
+    auto joint_id = JointId::by_name.find(name);
+    return (joint_id != JointId::by_name.end() && joint_id->second < 64) ?
+           uint64_t(1) << joint_id->second : 0;
+  }
+
+  uint64_t joint_mask = 0;
+  for (const auto & joint_name : group->second) {
+    joint_mask |= get_mask(joint_name);
+  }
+
+  return joint_mask;
+}
+
+uint64_t JointGroup::get_mask(const std::vector<std::string> & names)
+{
+  uint64_t joint_mask = 0;
+  for (const auto & name : names) {
+    joint_mask |= get_mask(name);
+  }
+
+  return joint_mask;
+}
+
+}  // namespace akushon
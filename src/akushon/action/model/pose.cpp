@@ -29,7 +29,7 @@ namespace akushon
 {
 
 Pose::Pose(const std::string & pose_name)
-: name(pose_name), speed(0.0), pause(0.0), joints({})
+: name(pose_name), speed(0.0), pause(0.0), via(0.0), duration(-1.0), joints({})
 {
 }
 
@@ -53,6 +53,26 @@ float Pose::get_pause() const
   return pause;
 }
 
+void Pose::set_via(float via)
+{
+  this->via = via;
+}
+
+float Pose::get_via() const
+{
+  return via;
+}
+
+void Pose::set_duration(float duration)
+{
+  this->duration = duration;
+}
+
+float Pose::get_duration() const
+{
+  return duration;
+}
+
 void Pose::set_name(const std::string & pose_name)
 {
   name = pose_name;
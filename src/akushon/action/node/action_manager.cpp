@@ -21,11 +21,17 @@
 #include <unistd.h>
 #include <limits.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <optional>
+#include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
@@ -33,43 +39,264 @@
 #include "akushon/action/node/action_manager.hpp"
 
 #include "akushon/action/model/action_name.hpp"
+#include "akushon/action/process/duration_estimator.hpp"
 #include "akushon/action/process/interpolator.hpp"
+#include "akushon/action/utils/action_loader.hpp"
+#include "akushon/action/utils/flight_recorder.hpp"
 #include "nlohmann/json.hpp"
-#include "tachimawari/joint/joint.hpp"
+#include "tachimawari/joint/model/joint.hpp"
+#include "tachimawari/joint/model/joint_id.hpp"
 
 namespace akushon
 {
 
+namespace
+{
+
+// the shortest decimal that reads back as the same float, so a dumped file
+// keeps the values as they were authored instead of their widened doubles
+double to_json_number(float value)
+{
+  char text[32];
+  for (int precision = 1; precision <= 9; ++precision) {
+    std::snprintf(text, sizeof(text), "%.*g", precision, value);
+    if (std::strtof(text, nullptr) == value) {
+      return std::strtod(text, nullptr);
+    }
+  }
+
+  return value;
+}
+
+}  // namespace
+
 ActionManager::ActionManager()
-: actions({}), is_running(false)
+: library(std::make_shared<ActionLibrary>()), is_running(false), layer_joint_mask(0)
 {
-  interpolator = std::make_shared<Interpolator>(std::vector<Action>(), Pose(""));
+  interpolator.emplace(std::vector<Action>(), Pose(""));
 }
 
 void ActionManager::insert_action(std::string action_name, const Action & action)
 {
-  actions.insert({action_name, action});
+  auto library = copy_library();
+  library->add_action(action_name, action);
+
+  this->library = library;
 }
 
 void ActionManager::delete_action(std::string action_name)
 {
-  actions.erase(action_name);
+  if (library->find_action(action_name) < 0) {
+    return;
+  }
+
+  auto library = copy_library();
+  library->remove_action(action_name);
+
+  this->library = library;
 }
 
 Action ActionManager::get_action(std::string action_name) const
 {
-  if (actions.find(action_name) != actions.end()) {
-    return actions.at(action_name);
+  int action_id = library->find_action(action_name);
+  if (action_id >= 0) {
+    load_chain(action_id);
+    return library->get_action(action_id);
   }
 
   return Action("");
 }
 
+Action ActionManager::get_action(int action_id) const
+{
+  load_chain(action_id);
+  return library->get_action(action_id);
+}
+
+int ActionManager::get_action_id(const std::string & action_name) const
+{
+  return library->find_action(action_name);
+}
+
+std::string ActionManager::get_action_name(int action_id) const
+{
+  for (const auto & [action_name, id] : library->get_action_ids()) {
+    if (id == action_id) {
+      return std::string(action_name);
+    }
+  }
+
+  return "";
+}
+
+const ActionLibrary::ActionIds & ActionManager::get_action_ids() const
+{
+  return library->get_action_ids();
+}
+
+int ActionManager::get_action_count() const
+{
+  return library->get_action_count();
+}
+
+std::shared_ptr<const ActionLibrary> ActionManager::get_library() const
+{
+  return library;
+}
+
+void ActionManager::share_library(const ActionManager & action_manager)
+{
+  library = action_manager.library;
+}
+
+void ActionManager::index_config(const std::string & path)
+{
+  // only the file names are read here, every action keeps an empty slot
+  // until its first use or until the prefetcher reaches it
+  auto library = std::make_shared<ActionLibrary>(this->library->get_generation() + 1);
+  auto action_loader = std::make_shared<ActionLoader>(path);
+
+  for (const auto & [action_name, entry] : action_loader->get_entries()) {
+    library->reserve_action(action_name);
+  }
+
+  this->library = library;
+  this->action_loader = action_loader;
+}
+
+void ActionManager::prefetch(const std::vector<std::string> & priority)
+{
+  if (action_loader) {
+    action_loader->prefetch(priority);
+  }
+}
+
+void ActionManager::preload(const std::string & action_name) const
+{
+  if (action_loader) {
+    action_loader->preload(action_name);
+  }
+}
+
+void ActionManager::preload_all() const
+{
+  if (action_loader) {
+    for (const auto & [action_name, entry] : action_loader->get_entries()) {
+      action_loader->preload(action_name);
+    }
+  }
+}
+
+void ActionManager::load_all() const
+{
+  if (!action_loader) {
+    return;
+  }
+
+  std::shared_ptr<ActionLibrary> loaded_library;
+  for (const auto & [action_key, action_id] : library->get_action_ids()) {
+    if (library->get_action_data(action_id).is_loaded) {
+      continue;
+    }
+
+    std::string action_name(action_key);
+
+    auto action_data = action_loader->take(action_name);
+    if (action_data) {
+      if (!loaded_library) {
+        loaded_library = copy_library();
+      }
+
+      loaded_library->add_action(action_name, load_action(*action_data, action_name));
+    }
+  }
+
+  if (loaded_library) {
+    library = loaded_library;
+  }
+}
+
+bool ActionManager::ensure_loaded(const std::string & action_name)
+{
+  int action_id = library->find_action(action_name);
+  if (action_id < 0) {
+    return false;
+  }
+
+  load_chain(action_id);
+
+  return library->get_action_data(action_id).is_loaded;
+}
+
+std::shared_ptr<const ActionLoader> ActionManager::get_action_loader() const
+{
+  return action_loader;
+}
+
+void ActionManager::load_chain(int action_id) const
+{
+  if (!action_loader) {
+    return;
+  }
+
+  // the whole chain is loaded up front so a chain never plays an empty slot,
+  // all of it into a single copy
+  std::shared_ptr<ActionLibrary> loaded_library;
+  std::shared_ptr<const ActionLibrary> library = this->library;
+
+  std::vector<bool> visited(library->get_action_count(), false);
+  while (action_id >= 0 && action_id < library->get_action_count() && !visited[action_id]) {
+    visited[action_id] = true;
+
+    if (!library->get_action_data(action_id).is_loaded) {
+      auto action_name = get_action_name(action_id);
+
+      auto action_data = action_loader->take(action_name);
+      if (action_data) {
+        if (!loaded_library) {
+          loaded_library = copy_library();
+          library = loaded_library;
+        }
+
+        loaded_library->add_action(action_name, load_action(*action_data, action_name));
+      }
+    }
+
+    action_id = library->get_action_data(action_id).next_action_id;
+  }
+
+  if (loaded_library) {
+    this->library = loaded_library;
+  }
+}
+
+std::shared_ptr<ActionLibrary> ActionManager::copy_library() const
+{
+  return std::make_shared<ActionLibrary>(*library, library->get_generation() + 1);
+}
+
 void ActionManager::load_config(const std::string & path)
 {
+  // every load builds a new generation, the previous one is released as a
+  // whole once no interpolator is playing from it anymore
+  auto library = std::make_shared<ActionLibrary>(this->library->get_generation() + 1);
+
+  // in the order of the names, as index_config() does, so the ids do not
+  // depend on how the directory happens to list its files
+  std::vector<std::filesystem::path> file_paths;
   for (const auto & entry : std::filesystem::directory_iterator(path)) {
+    file_paths.push_back(entry.path());
+  }
+
+  std::sort(
+    file_paths.begin(), file_paths.end(),
+    [](const std::filesystem::path & a, const std::filesystem::path & b) {
+      return a.stem().string() < b.stem().string();
+    });
+
+  for (const auto & file_path : file_paths) {
     std::string name = "";
-    std::string file_name = entry.path();
+    std::string file_name = file_path;
     std::string extension_json = ".json";
     for (int i = path.length(); i < file_name.length() - extension_json.length(); i++) {
       name += file_name[i];
@@ -81,14 +308,15 @@ void ActionManager::load_config(const std::string & path)
       std::ifstream file(file_name);
       nlohmann::json action_data = nlohmann::json::parse(file);
 
-      Action action = load_action(action_data, name);
-
-      actions.insert({name, action});
+      library->add_action(name, load_action(action_data, name));
     } catch (nlohmann::json::parse_error & ex) {
       // TODO(any): will be used for logging
       // std::cerr << "parse error at byte " << ex.byte << std::endl;
     }
   }
+
+  this->library = library;
+  action_loader = nullptr;
 }
 
 Action ActionManager::load_action(
@@ -116,7 +344,18 @@ Action ActionManager::load_action(
             }
 
             pose.set_pause(raw_pose["pause"]);
-            pose.set_speed(raw_pose["speed"]);
+
+            // a pose with duration_ms may leave out its speed
+            if (raw_pose.contains("speed")) {
+              pose.set_speed(raw_pose["speed"]);
+            }
+
+            if (raw_pose.contains("duration_ms")) {
+              pose.set_duration(raw_pose["duration_ms"]);
+            }
+
+            // an action wide via applies to every pose that has none
+            pose.set_via(raw_pose.value("via", action_data.value("via", 0.0f)));
             pose.set_joints(joints);
             action.add_pose(pose);
           }
@@ -137,70 +376,513 @@ Action ActionManager::load_action(
   return action;
 }
 
-void ActionManager::start(std::string action_name, const Pose & initial_pose)
+nlohmann::json ActionManager::dump_action(const Action & action) const
 {
-  std::vector<Action> target_actions;
+  nlohmann::json action_data;
+  action_data["name"] = action.get_name();
+  action_data["next"] = action.get_next_action();
+  action_data["start_delay"] = action.get_start_delay();
+  action_data["stop_delay"] = action.get_stop_delay();
+  action_data["poses"] = nlohmann::json::array();
+
+  for (const auto & pose : action.get_poses()) {
+    nlohmann::json raw_pose;
+    raw_pose["name"] = pose.get_name();
+    raw_pose["pause"] = to_json_number(pose.get_pause());
+    raw_pose["speed"] = to_json_number(pose.get_speed());
+    if (pose.get_via() > 0.0) {
+      raw_pose["via"] = to_json_number(pose.get_via());
+    }
 
-  while (true) {
-    const auto & action = actions.at(action_name);
+    if (pose.get_duration() >= 0.0) {
+      raw_pose["duration_ms"] = to_json_number(pose.get_duration());
+    }
+    raw_pose["joints"] = nlohmann::json::object();
 
-    target_actions.push_back(action);
+    for (const auto & joint : pose.get_joints()) {
+      for (const auto & [joint_name, joint_id] : tachimawari::joint::JointId::by_name) {
+        if (joint_id == joint.get_id()) {
+          raw_pose["joints"][joint_name] = to_json_number(joint.get_position());
+          break;
+        }
+      }
+    }
 
-    if (action.get_next_action() != "") {
-      std::string next_action_name = action.get_next_action();
+    action_data["poses"].push_back(raw_pose);
+  }
 
-      if (actions.find(next_action_name) != actions.end()) {
-        action_name = next_action_name;
-      } else {
-        break;
-      }
-    } else {
-      break;
+  return action_data;
+}
+
+int ActionManager::estimate_duration(int action_id, bool include_chain) const
+{
+  if (action_id < 0 || action_id >= library->get_action_count()) {
+    return -1;
+  }
+
+  load_chain(action_id);
+
+  DurationEstimator duration_estimator(library);
+  return include_chain ?
+         duration_estimator.estimate_chain(action_id) : duration_estimator.estimate(action_id);
+}
+
+int ActionManager::estimate_duration(
+  int action_id, const Pose & initial_pose, bool include_chain) const
+{
+  if (action_id < 0 || action_id >= library->get_action_count()) {
+    return -1;
+  }
+
+  load_chain(action_id);
+
+  DurationEstimator duration_estimator(library);
+  return include_chain ?
+         duration_estimator.estimate_chain(action_id, initial_pose) :
+         duration_estimator.estimate(action_id, initial_pose);
+}
+
+Action ActionManager::convert_to_duration(int action_id) const
+{
+  if (action_id < 0 || action_id >= library->get_action_count()) {
+    return Action("");
+  }
+
+  load_chain(action_id);
+
+  DurationEstimator duration_estimator(library);
+  return apply_durations(action_id, duration_estimator.estimate_pose_durations(action_id));
+}
+
+Action ActionManager::convert_to_duration(int action_id, const Pose & initial_pose) const
+{
+  if (action_id < 0 || action_id >= library->get_action_count()) {
+    return Action("");
+  }
+
+  load_chain(action_id);
+
+  DurationEstimator duration_estimator(library);
+  return apply_durations(
+    action_id, duration_estimator.estimate_pose_durations(action_id, initial_pose));
+}
+
+Action ActionManager::apply_durations(int action_id, const std::vector<int> & durations) const
+{
+  auto action = library->get_action(action_id);
+
+  Action result = action;
+  result.reset();
+
+  for (int i = 0; i < action.get_pose_count(); ++i) {
+    Pose pose = action.get_pose(i);
+
+    if (i < static_cast<int>(durations.size())) {
+      pose.set_duration(durations[i]);
     }
+
+    result.add_pose(pose);
+  }
+
+  return result;
+}
+
+void ActionManager::start(
+  std::string action_name, const Pose & initial_pose, const ActionTransform & transform)
+{
+  int action_id = library->find_action(action_name);
+  if (action_id < 0) {
+    throw std::out_of_range("action " + action_name + " is not found");
   }
 
-  interpolator = std::make_shared<Interpolator>(target_actions, initial_pose);
+  start(action_id, initial_pose, transform);
+}
+
+void ActionManager::start(
+  int action_id, const Pose & initial_pose, const ActionTransform & transform)
+{
+  auto action_ids = get_chain(action_id);
+
+  interpolator.emplace(library, action_ids, get_main_pose(initial_pose), transform);
+  interpolator->set_loop(get_loop_index(action_ids), -1);
+  is_running = true;
+}
+
+void ActionManager::start_loop(
+  std::string action_name, const Pose & initial_pose, int repeat_count, bool loop_delays,
+  const ActionTransform & transform)
+{
+  int action_id = library->find_action(action_name);
+  if (action_id < 0) {
+    throw std::out_of_range("action " + action_name + " is not found");
+  }
+
+  start_loop(action_id, initial_pose, repeat_count, loop_delays, transform);
+}
+
+void ActionManager::start_loop(
+  int action_id, const Pose & initial_pose, int repeat_count, bool loop_delays,
+  const ActionTransform & transform)
+{
+  auto action_ids = get_chain(action_id);
+  int loop_index = get_loop_index(action_ids);
+
+  interpolator.emplace(library, action_ids, get_main_pose(initial_pose), transform);
+  interpolator->set_loop((loop_index < 0) ? 0 : loop_index, repeat_count, loop_delays);
+  is_running = true;
+}
+
+void ActionManager::start_loop(
+  const Action & action, const Pose & initial_pose, int repeat_count, bool loop_delays,
+  const ActionTransform & transform)
+{
+  std::vector<Action> target_actions {action};
+
+  interpolator.emplace(target_actions, get_main_pose(initial_pose), transform);
+  interpolator->set_loop(0, repeat_count, loop_delays);
   is_running = true;
 }
 
-void ActionManager::start(const Action & action, const Pose & initial_pose)
+void ActionManager::start(
+  const Action & action, const Pose & initial_pose, const ActionTransform & transform)
 {
   std::vector<Action> target_actions {action};
 
-  interpolator = std::make_shared<Interpolator>(target_actions, initial_pose);
+  interpolator.emplace(target_actions, get_main_pose(initial_pose), transform);
   is_running = true;
 }
 
+void ActionManager::start_layer(
+  int action_id, uint64_t joint_mask, const Pose & initial_pose,
+  const ActionTransform & transform)
+{
+  auto action_ids = get_chain(action_id);
+
+  Interpolator interpolator(
+    library, action_ids, get_layer_pose(joint_mask, initial_pose), transform);
+  interpolator.set_loop(get_loop_index(action_ids), -1);
+
+  add_layer(joint_mask, std::move(interpolator));
+}
+
+void ActionManager::start_layer(
+  const Action & action, uint64_t joint_mask, const Pose & initial_pose,
+  const ActionTransform & transform)
+{
+  std::vector<Action> target_actions {action};
+
+  add_layer(
+    joint_mask, Interpolator(target_actions, get_layer_pose(joint_mask, initial_pose), transform));
+}
+
+int ActionManager::get_layer_count() const
+{
+  return layers.size();
+}
+
+std::vector<int> ActionManager::get_chain(int action_id)
+{
+  load_chain(action_id);
+
+  // a chain that links back into itself stops at the first repeated action,
+  // the interpolator loops over it instead
+  std::vector<int> target_action_ids;
+  std::vector<bool> visited(library->get_action_count(), false);
+
+  while (action_id >= 0 && !visited[action_id]) {
+    visited[action_id] = true;
+    target_action_ids.push_back(action_id);
+    action_id = library->get_action_data(action_id).next_action_id;
+  }
+
+  return target_action_ids;
+}
+
+int ActionManager::get_loop_index(const std::vector<int> & action_ids) const
+{
+  if (action_ids.empty()) {
+    return -1;
+  }
+
+  int next_action_id = library->get_action_data(action_ids.back()).next_action_id;
+
+  auto loop = std::find(action_ids.begin(), action_ids.end(), next_action_id);
+  return (loop != action_ids.end()) ? loop - action_ids.begin() : -1;
+}
+
+Pose ActionManager::get_main_pose(const Pose & initial_pose)
+{
+  if (layers.empty()) {
+    return initial_pose;
+  }
+
+  // a finished layer hands its joints back to the main action, which starts
+  // them from where the layer left them
+  std::vector<tachimawari::joint::Joint> held_joints;
+  for (const auto & layer : layers) {
+    if (layer.interpolator.is_finished()) {
+      for (const auto & joint : layer.interpolator.get_joints()) {
+        if (layer.joint_mask & (uint64_t(1) << joint.get_id())) {
+          held_joints.push_back(joint);
+        }
+      }
+    }
+  }
+
+  layers.erase(
+    std::remove_if(
+      layers.begin(), layers.end(),
+      [](const Layer & layer) {return layer.interpolator.is_finished();}), layers.end());
+
+  layer_joint_mask = 0;
+  for (const auto & layer : layers) {
+    layer_joint_mask |= layer.joint_mask;
+  }
+
+  std::vector<tachimawari::joint::Joint> joints;
+  for (const auto & joint : initial_pose.get_joints()) {
+    if (layer_joint_mask & (uint64_t(1) << joint.get_id())) {
+      continue;
+    }
+
+    auto held_joint = std::find_if(
+      held_joints.begin(), held_joints.end(),
+      [&](const tachimawari::joint::Joint & held) {return held.get_id() == joint.get_id();});
+
+    joints.push_back((held_joint != held_joints.end()) ? *held_joint : joint);
+  }
+
+  Pose pose(initial_pose.get_name());
+  pose.set_joints(joints);
+
+  return pose;
+}
+
+Pose ActionManager::get_layer_pose(uint64_t joint_mask, const Pose & initial_pose)
+{
+  // the layer starts from the commanded joints where there are any, the
+  // measured ones lag behind them
+  auto current_joints = get_joints();
+
+  std::vector<tachimawari::joint::Joint> joints;
+  for (const auto & joint : initial_pose.get_joints()) {
+    if (!(joint_mask & (uint64_t(1) << joint.get_id()))) {
+      continue;
+    }
+
+    auto current_joint = std::find_if(
+      current_joints.begin(), current_joints.end(),
+      [&](const tachimawari::joint::Joint & current) {return current.get_id() == joint.get_id();});
+
+    joints.push_back((current_joint != current_joints.end()) ? *current_joint : joint);
+  }
+
+  Pose pose(initial_pose.get_name());
+  pose.set_joints(joints);
+
+  return pose;
+}
+
+void ActionManager::add_layer(uint64_t joint_mask, Interpolator && interpolator)
+{
+  // older layers give up the joints of the new one, and are dropped once
+  // they have none left
+  for (auto & layer : layers) {
+    layer.joint_mask &= ~joint_mask;
+  }
+
+  layers.erase(
+    std::remove_if(
+      layers.begin(), layers.end(),
+      [](const Layer & layer) {return layer.joint_mask == 0;}), layers.end());
+
+  layers.push_back(Layer{joint_mask, std::move(interpolator)});
+  layer_joint_mask |= joint_mask;
+}
+
 void ActionManager::process(int time)
 {
   if (interpolator) {
     interpolator->process(time);
 
+    flight_recorder.record(time, *interpolator);
+
     if (interpolator->is_finished()) {
-      interpolator = nullptr;
+      // the next queued action starts from where this one ended on this very
+      // tick, so there is no gap between them
+      Pose pose("queued_pose");
+      pose.set_joints(interpolator->get_joints());
+
+      interpolator.reset();
+
+      if (start_next(pose)) {
+        interpolator->process(time);
+      }
     }
   } else {
     is_running = false;
   }
+
+  for (auto & layer : layers) {
+    if (!layer.interpolator.is_finished()) {
+      layer.interpolator.process(time);
+    }
+  }
+
+  flight_recorder.save_pending();
 }
 
 void ActionManager::brake()
 {
-  interpolator = nullptr;
+  interpolator.reset();
+  clear_queue();
+
+  layers.clear();
+  layer_joint_mask = 0;
+}
+
+void ActionManager::enqueue(int action_id, int priority, const ActionTransform & transform)
+{
+  action_queue.emplace(priority, QueuedAction{action_id, nullptr, transform});
+}
+
+void ActionManager::enqueue(
+  std::shared_ptr<const Action> action, int priority, const ActionTransform & transform)
+{
+  action_queue.emplace(priority, QueuedAction{-1, action, transform});
+}
+
+void ActionManager::preempt(
+  int action_id, const Pose & initial_pose, const ActionTransform & transform)
+{
+  clear_queue();
+  start(action_id, get_current_pose(initial_pose), transform);
+}
+
+void ActionManager::preempt(
+  const Action & action, const Pose & initial_pose, const ActionTransform & transform)
+{
+  clear_queue();
+  start(action, get_current_pose(initial_pose), transform);
+}
+
+bool ActionManager::start_next(const Pose & initial_pose)
+{
+  if (action_queue.empty()) {
+    return false;
+  }
+
+  auto queued_action = action_queue.begin()->second;
+  action_queue.erase(action_queue.begin());
+
+  if (queued_action.action) {
+    start(*queued_action.action, initial_pose, queued_action.transform);
+  } else {
+    start(queued_action.action_id, initial_pose, queued_action.transform);
+  }
+
+  return true;
+}
+
+void ActionManager::clear_queue()
+{
+  action_queue.clear();
+}
+
+int ActionManager::get_queue_size() const
+{
+  return action_queue.size();
+}
+
+Pose ActionManager::get_current_pose(const Pose & fallback_pose) const
+{
+  // an interrupted action hands over its commanded joints, as the measured
+  // ones lag behind them
+  if (!interpolator) {
+    return fallback_pose;
+  }
+
+  Pose pose("current_pose");
+  pose.set_joints(interpolator->get_joints());
+
+  return pose;
 }
 
 bool ActionManager::is_playing() const
 {
-  return is_running;
+  // combined motions finish with the longest of their layers
+  return is_running || std::any_of(
+    layers.begin(), layers.end(),
+    [](const Layer & layer) {return !layer.interpolator.is_finished();});
+}
+
+FlightRecorder & ActionManager::get_flight_recorder()
+{
+  return flight_recorder;
+}
+
+const FlightRecorder & ActionManager::get_flight_recorder() const
+{
+  return flight_recorder;
+}
+
+int ActionManager::get_idle_until() const
+{
+  if (!interpolator) {
+    return -1;
+  }
+
+  int idle_until = interpolator->get_idle_until();
+
+  // the earliest layer wakes the whole manager up
+  for (const auto & layer : layers) {
+    if (idle_until < 0) {
+      break;
+    }
+
+    if (!layer.interpolator.is_finished()) {
+      int layer_idle_until = layer.interpolator.get_idle_until();
+      idle_until = (layer_idle_until < 0) ? -1 : std::min(idle_until, layer_idle_until);
+    }
+  }
+
+  return idle_until;
 }
 
 std::vector<tachimawari::joint::Joint> ActionManager::get_joints() const
 {
+  std::vector<tachimawari::joint::Joint> joints;
   if (interpolator) {
-    return interpolator->get_joints();
+    joints = interpolator->get_joints();
   }
 
-  return {};
+  if (layers.empty()) {
+    return joints;
+  }
+
+  // every layer owns its joints, so the merged joints hold each id once
+  joints.erase(
+    std::remove_if(
+      joints.begin(), joints.end(),
+      [&](const tachimawari::joint::Joint & joint) {
+        return layer_joint_mask & (uint64_t(1) << joint.get_id());
+      }), joints.end());
+
+  for (const auto & layer : layers) {
+    for (const auto & joint : layer.interpolator.get_joints()) {
+      if (layer.joint_mask & (uint64_t(1) << joint.get_id())) {
+        joints.push_back(joint);
+      }
+    }
+  }
+
+  std::sort(
+    joints.begin(), joints.end(),
+    [](const tachimawari::joint::Joint & a, const tachimawari::joint::Joint & b) {
+      return a.get_id() < b.get_id();
+    });
+
+  return joints;
 }
 
 }  // namespace akushon
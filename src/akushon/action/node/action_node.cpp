@@ -20,15 +20,24 @@
 
 #include "akushon/action/node/action_node.hpp"
 
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
 #include <iomanip>
+#include <iostream>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <utility>
 #include <vector>
 
 #include "akushon/action/model/action_name.hpp"
+#include "akushon/action/model/joint_group.hpp"
 #include "akushon/action/model/pose.hpp"
 #include "akushon/action/node/action_manager.hpp"
+#include "akushon/action/process/duration_estimator.hpp"
 #include "nlohmann/json.hpp"
 #include "rclcpp/rclcpp.hpp"
 #include "tachimawari/joint/joint.hpp"
@@ -41,20 +50,43 @@ std::string ActionNode::get_node_prefix() {return "action";}
 
 std::string ActionNode::run_action_topic() {return get_node_prefix() + "/run_action";}
 
+std::string ActionNode::enqueue_action_topic() {return get_node_prefix() + "/enqueue_action";}
+
+std::string ActionNode::preempt_action_topic() {return get_node_prefix() + "/preempt_action";}
+
+std::string ActionNode::layer_action_topic() {return get_node_prefix() + "/layer_action";}
+
 std::string ActionNode::brake_action_topic() {return get_node_prefix() + "/brake_action";}
 
 std::string ActionNode::status_topic() {return get_node_prefix() + "/status";}
+std::string ActionNode::dump_flight_record_topic()
+{
+  return get_node_prefix() + "/dump_flight_record";
+}
+
+std::string ActionNode::cache_status_service() {return get_node_prefix() + "/cache_status";}
+
+std::string ActionNode::action_ids_service() {return get_node_prefix() + "/action_ids";}
+
+std::string ActionNode::durations_service() {return get_node_prefix() + "/durations";}
+
+std::string ActionNode::teach_start_service() {return get_node_prefix() + "/teach_start";}
+
+std::string ActionNode::teach_stop_service() {return get_node_prefix() + "/teach_stop";}
 
 ActionNode::ActionNode(
   rclcpp::Node::SharedPtr node, std::shared_ptr<ActionManager> & action_manager)
-: node(node), action_manager(action_manager), initial_pose(Pose("initial_pose"))
+: node(node), action_manager(action_manager), initial_pose(Pose("initial_pose")),
+  teach_start_time(0.0)
 {
   {
     using tachimawari::joint::JointNode;
 
     current_joints_subscriber = node->create_subscription<CurrentJoints>(
-      JointNode::current_joints_topic(), 10, [this](const CurrentJoints::SharedPtr message) {
+      JointNode::current_joints_topic(), 10, [this](const CurrentJoints::ConstSharedPtr message) {
         {
+          std::lock_guard<std::mutex> lock(this->mutex);
+
           using tachimawari::joint::Joint;
           std::vector<Joint> current_joints;
 
@@ -62,7 +94,7 @@ ActionNode::ActionNode(
             current_joints.push_back(Joint(joint.id, joint.position));
           }
 
-          this->initial_pose.set_joints(current_joints);
+          this->set_current_joints(current_joints);
         }
       });
 
@@ -74,27 +106,497 @@ ActionNode::ActionNode(
   run_action_subscriber = node->create_subscription<RunAction>(
     run_action_topic(), 10, [this](std::shared_ptr<RunAction> message) {
       std::cout << message->action_name << std::endl;
-      if (message->control_type == RUN_ACTION_BY_NAME) {
-        this->start(message->action_name);
-      } else {
-        nlohmann::json action_data = nlohmann::json::parse(message->json);
-        Action action = this->action_manager->load_action(action_data, message->action_name);
 
-        this->start(action);
+      this->preload(*message);
+      this->post([this, message]() {this->run_action(*message);});
+
+      if (this->wakeup_callback) {
+        this->wakeup_callback();
+      }
+    });
+
+  enqueue_action_subscriber = node->create_subscription<RunAction>(
+    enqueue_action_topic(), 10, [this](std::shared_ptr<RunAction> message) {
+      this->preload(*message);
+      this->post([this, message]() {this->enqueue_action(*message);});
+
+      if (this->wakeup_callback) {
+        this->wakeup_callback();
+      }
+    });
+
+  preempt_action_subscriber = node->create_subscription<RunAction>(
+    preempt_action_topic(), 10, [this](std::shared_ptr<RunAction> message) {
+      this->preload(*message);
+      this->post([this, message]() {this->preempt_action(*message);});
+
+      if (this->wakeup_callback) {
+        this->wakeup_callback();
+      }
+    });
+
+  layer_action_subscriber = node->create_subscription<RunAction>(
+    layer_action_topic(), 10, [this](std::shared_ptr<RunAction> message) {
+      this->preload(*message);
+      this->post([this, message]() {this->layer_action(*message);});
+
+      if (this->wakeup_callback) {
+        this->wakeup_callback();
       }
     });
 
   brake_action_subscriber = node->create_subscription<Empty>(
     brake_action_topic(), 10,
-    [this](std::shared_ptr<Empty> message) {this->action_manager->brake();});
+    [this](std::shared_ptr<Empty> message) {
+      this->post([this]() {this->brake();});
+
+      if (this->wakeup_callback) {
+        this->wakeup_callback();
+      }
+    });
+
+  dump_flight_record_subscriber = node->create_subscription<Empty>(
+    dump_flight_record_topic(), 10,
+    [this](std::shared_ptr<Empty> message) {
+      // the ring is copied on the next tick and written by the recorder
+      this->post(
+        [this]() {
+          this->action_manager->get_flight_recorder().save_in_background("request");
+        });
+    });
+
+  cache_status_service_server = node->create_service<GetActions>(
+    cache_status_service(),
+    [this](std::shared_ptr<GetActions::Request> request,
+    std::shared_ptr<GetActions::Response> response) {
+      std::lock_guard<std::mutex> lock(this->cache_mutex);
+
+      nlohmann::json status;
+      status["hit"] = this->action_cache.get_hit_count();
+      status["miss"] = this->action_cache.get_miss_count();
+      status["size"] = this->action_cache.get_size();
+      status["capacity"] = this->action_cache.get_capacity();
+
+      response->json = status.dump();
+    }
+  );
+
+  action_ids_service_server = node->create_service<GetActions>(
+    action_ids_service(),
+    [this](std::shared_ptr<GetActions::Request> request,
+    std::shared_ptr<GetActions::Response> response) {
+      std::shared_ptr<const ActionLibrary> library;
+      {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        library = this->action_manager->get_library();
+      }
+
+      nlohmann::json action_ids = nlohmann::json::object();
+      for (const auto & [action_name, action_id] : library->get_action_ids()) {
+        action_ids[std::string(action_name)] = action_id;
+      }
+
+      response->json = action_ids.dump();
+    }
+  );
+
+  durations_service_server = node->create_service<GetActions>(
+    durations_service(),
+    [this](std::shared_ptr<GetActions::Request> request,
+    std::shared_ptr<GetActions::Response> response) {
+      // parsed and estimated outside of the lock, only the loaded library and
+      // the current joints are taken under it
+      this->action_manager->preload_all();
+
+      std::shared_ptr<const ActionLibrary> library;
+      Pose initial_pose("initial_pose");
+      {
+        std::lock_guard<std::mutex> lock(this->mutex);
+
+        this->action_manager->load_all();
+        library = this->action_manager->get_library();
+        initial_pose = this->initial_pose;
+      }
+
+      bool from_current = !initial_pose.get_joints().empty();
+
+      DurationEstimator duration_estimator(library);
+
+      nlohmann::json durations = nlohmann::json::object();
+      for (const auto & [action_name, action_id] : library->get_action_ids()) {
+        auto & duration = durations[std::string(action_name)];
+        duration["action"] = duration_estimator.estimate(action_id);
+        duration["chain"] = duration_estimator.estimate_chain(action_id);
+
+        if (from_current) {
+          duration["action_from_current"] = duration_estimator.estimate(action_id, initial_pose);
+          duration["chain_from_current"] = duration_estimator.estimate_chain(
+            action_id, initial_pose);
+        }
+      }
+
+      response->json = durations.dump();
+    }
+  );
+
+  teach_start_service_server = node->create_service<GetActions>(
+    teach_start_service(),
+    [this](std::shared_ptr<GetActions::Request> request,
+    std::shared_ptr<GetActions::Response> response) {
+      std::vector<tachimawari::joint::Joint> joints;
+      {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        joints = this->initial_pose.get_joints();
+      }
+
+      nlohmann::json status;
+
+      if (joints.empty()) {
+        status["recording"] = false;
+      } else {
+        // the buffers are allocated before the recorder is swapped in
+        TeachRecorder teach_recorder;
+        teach_recorder.start(0, joints);
+
+        {
+          std::lock_guard<std::mutex> lock(this->mutex);
+
+          this->teach_start_time = this->node->now().seconds();
+          this->teach_recorder = std::move(teach_recorder);
+        }
+
+        status["recording"] = true;
+      }
+
+      response->json = status.dump();
+    }
+  );
+
+  // the request is {"name": ..., "tolerance": ...}, the response status is
+  // the recorded action in the format of the action files
+  teach_stop_service_server = node->create_service<SaveActions>(
+    teach_stop_service(),
+    [this](std::shared_ptr<SaveActions::Request> request,
+    std::shared_ptr<SaveActions::Response> response) {
+      // only the copy is taken under the lock, the motion loop never waits on
+      // the extraction
+      TeachRecorder teach_recorder;
+      {
+        std::lock_guard<std::mutex> lock(this->mutex);
+
+        this->teach_recorder.stop();
+        teach_recorder = this->teach_recorder;
+      }
+
+      nlohmann::json options = nlohmann::json::parse(request->json, nullptr, false);
+
+      std::string name = "teach";
+      float tolerance = 1.0;
+      if (options.is_object()) {
+        if (options.contains("name") && options["name"].is_string()) {
+          name = options["name"].get<std::string>();
+        }
+
+        if (options.contains("tolerance") && options["tolerance"].is_number()) {
+          tolerance = options["tolerance"].get<float>();
+        }
+      }
+
+      Action action = teach_recorder.extract(name, tolerance);
+
+      response->status = this->action_manager->dump_action(action).dump(2);
+    }
+  );
+}
+
+void ActionNode::run_action(const RunAction & message)
+{
+  if (input_log) {
+    input_log->write_action(
+      InputLog::RUN_ACTION, message.control_type, message.action_name, message.json);
+  }
+
+  // {"repeat": n, "loop_delays": false} plays the action n times, or until
+  // braked when n is negative
+  nlohmann::json options = nlohmann::json::parse(message.json, nullptr, false);
+  if (options.is_object() && options.contains("repeat")) {
+    if (initial_pose.get_joints().empty() || !options["repeat"].is_number()) {
+      return;
+    }
+
+    int repeat_count = options["repeat"].get<int>();
+
+    bool loop_delays = true;
+    if (options.contains("loop_delays") && options["loop_delays"].is_boolean()) {
+      loop_delays = options["loop_delays"].get<bool>();
+    }
+
+    if (message.control_type == RUN_ACTION_BY_JSON) {
+      action_manager->start_loop(
+        *get_cached_action(message), initial_pose, repeat_count, loop_delays,
+        get_transform(message));
+    } else {
+      int action_id = get_action_id(message);
+      if (action_id >= 0) {
+        action_manager->start_loop(
+          action_id, initial_pose, repeat_count, loop_delays, get_transform(message));
+      }
+    }
+
+    return;
+  }
+
+  if (message.control_type == RUN_ACTION_BY_ID) {
+    int action_id = get_action_id(message);
+    if (action_id >= 0) {
+      start(action_id, get_transform(message));
+    }
+
+    return;
+  }
+
+  if (message.control_type == RUN_ACTION_BY_NAME) {
+    start(message.action_name, get_transform(message));
+  } else {
+    start(*get_cached_action(message), get_transform(message));
+  }
+}
+
+void ActionNode::enqueue_action(const RunAction & message)
+{
+  if (input_log) {
+    input_log->write_action(
+      InputLog::ENQUEUE_ACTION, message.control_type, message.action_name, message.json);
+  }
+
+  int priority = get_priority(message);
+  if (message.control_type == RUN_ACTION_BY_JSON) {
+    action_manager->enqueue(get_cached_action(message), priority, get_transform(message));
+  } else {
+    int action_id = get_action_id(message);
+    if (action_id < 0) {
+      return;
+    }
+
+    action_manager->enqueue(action_id, priority, get_transform(message));
+  }
+
+  // an idle node starts the queue right away
+  if (!action_manager->is_playing() && !initial_pose.get_joints().empty()) {
+    action_manager->start_next(initial_pose);
+  }
+}
+
+void ActionNode::preempt_action(const RunAction & message)
+{
+  if (input_log) {
+    input_log->write_action(
+      InputLog::PREEMPT_ACTION, message.control_type, message.action_name, message.json);
+  }
+
+  // without a playing action the measured joints are needed to start from
+  if (!action_manager->is_playing() && initial_pose.get_joints().empty()) {
+    return;
+  }
+
+  // started here rather than on the next tick, so the motion begins at most
+  // one tick after the message arrives
+  if (message.control_type == RUN_ACTION_BY_JSON) {
+    action_manager->preempt(*get_cached_action(message), initial_pose, get_transform(message));
+  } else {
+    int action_id = get_action_id(message);
+    if (action_id >= 0) {
+      action_manager->preempt(action_id, initial_pose, get_transform(message));
+    }
+  }
+}
+
+void ActionNode::layer_action(const RunAction & message)
+{
+  if (input_log) {
+    input_log->write_action(
+      InputLog::LAYER_ACTION, message.control_type, message.action_name, message.json);
+  }
+
+  uint64_t joint_mask = get_joint_mask(message);
+  if (joint_mask == 0 || initial_pose.get_joints().empty()) {
+    return;
+  }
+
+  if (message.control_type == RUN_ACTION_BY_JSON) {
+    action_manager->start_layer(
+      *get_cached_action(message), joint_mask, initial_pose, get_transform(message));
+  } else {
+    int action_id = get_action_id(message);
+    if (action_id >= 0) {
+      action_manager->start_layer(action_id, joint_mask, initial_pose, get_transform(message));
+    }
+  }
+}
+
+void ActionNode::preload(const RunAction & message)
+{
+  if (message.control_type == RUN_ACTION_BY_JSON) {
+    get_cached_action(message);
+    return;
+  }
+
+  if (!action_manager->get_action_loader()) {
+    return;
+  }
+
+  std::string action_name = message.action_name;
+  if (message.control_type == RUN_ACTION_BY_ID) {
+    std::lock_guard<std::mutex> lock(mutex);
+    action_name = action_manager->get_action_name(get_action_id(message));
+  }
+
+  action_manager->preload(action_name);
+}
+
+std::shared_ptr<const Action> ActionNode::get_cached_action(const RunAction & message)
+{
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+
+    auto action = action_cache.find(message.action_name, message.json);
+    if (action) {
+      return action;
+    }
+  }
+
+  nlohmann::json action_data = nlohmann::json::parse(message.json);
+  auto action = std::make_shared<const Action>(
+    action_manager->load_action(action_data, message.action_name));
+
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  action_cache.insert(message.action_name, message.json, action);
+
+  return action;
 }
 
-bool ActionNode::start(const std::string & action_name)
+int ActionNode::get_action_id(const RunAction & message) const
+{
+  if (message.control_type == RUN_ACTION_BY_ID) {
+    // the id resolved from action_ids is carried as decimal text in
+    // action_name, anything but a whole number of an action is ignored
+    const char * begin = message.action_name.c_str();
+    char * end = nullptr;
+
+    errno = 0;
+    long action_id = std::strtol(begin, &end, 10);
+    if (end == begin || end != begin + message.action_name.size() || errno == ERANGE) {
+      return -1;
+    }
+
+    return (action_id >= 0 && action_id < action_manager->get_action_count()) ? action_id : -1;
+  }
+
+  return action_manager->get_action_id(message.action_name);
+}
+
+int ActionNode::get_priority(const RunAction & message) const
+{
+  // read from the action itself when it is sent as json, otherwise the json
+  // field only carries the options
+  nlohmann::json options = nlohmann::json::parse(message.json, nullptr, false);
+  if (!options.is_object() || !options.contains("priority") || !options["priority"].is_number()) {
+    return 0;
+  }
+
+  return options["priority"].get<int>();
+}
+
+uint64_t ActionNode::get_joint_mask(const RunAction & message) const
+{
+  // either a single group or joint name, or a list of them
+  nlohmann::json options = nlohmann::json::parse(message.json, nullptr, false);
+  if (!options.is_object() || !options.contains("layer")) {
+    return 0;
+  }
+
+  const auto & layer = options["layer"];
+  if (layer.is_string()) {
+    return JointGroup::get_mask(layer.get<std::string>());
+  } else if (layer.is_array()) {
+    // a list with anything but names is rejected as a whole
+    std::vector<std::string> names;
+    for (const auto & name : layer) {
+      if (!name.is_string()) {
+        return 0;
+      }
+
+      names.push_back(name.get<std::string>());
+    }
+
+    return JointGroup::get_mask(names);
+  }
+
+  return 0;
+}
+
+ActionTransform ActionNode::get_transform(const RunAction & message) const
+{
+  // {"transform": {"mirror": true, "time_scale": 1.2, "offsets": {"neck_pitch": -3}}}
+  ActionTransform transform;
+
+  nlohmann::json options = nlohmann::json::parse(message.json, nullptr, false);
+  if (!options.is_object() || !options.contains("transform") ||
+    !options["transform"].is_object())
+  {
+    return transform;
+  }
+
+  // a field of the wrong type is ignored like an unknown joint name
+  const auto & transform_data = options["transform"];
+  if (transform_data.contains("mirror") && transform_data["mirror"].is_boolean()) {
+    transform.set_mirror(transform_data["mirror"].get<bool>());
+  }
+
+  if (transform_data.contains("time_scale") && transform_data["time_scale"].is_number()) {
+    transform.set_time_scale(transform_data["time_scale"].get<float>());
+  }
+
+  if (transform_data.contains("offsets") && transform_data["offsets"].is_object()) {
+    for (const auto & [joint_name, offset] : transform_data["offsets"].items()) {
+      auto joint_id = tachimawari::joint::JointId::by_name.find(joint_name);
+      if (joint_id != tachimawari::joint::JointId::by_name.end() && offset.is_number()) {
+        transform.set_offset(joint_id->second, offset);
+      }
+    }
+  }
+
+  return transform;
+}
+
+void ActionNode::brake()
+{
+  if (input_log) {
+    input_log->write_brake_action();
+  }
+
+  action_manager->brake();
+}
+
+void ActionNode::set_current_joints(const std::vector<tachimawari::joint::Joint> & joints)
+{
+  if (input_log) {
+    input_log->write_current_joints(joints);
+  }
+
+  initial_pose.set_joints(joints);
+
+  if (teach_recorder.is_recording()) {
+    teach_recorder.record((node->now().seconds() - teach_start_time) * 1000, joints);
+  }
+}
+
+bool ActionNode::start(const std::string & action_name, const ActionTransform & transform)
 {
   Pose pose = this->initial_pose;
 
   if (!pose.get_joints().empty()) {
-    action_manager->start(action_name, pose);
+    action_manager->start(action_name, pose, transform);
   } else {
     return false;
   }
@@ -102,12 +604,16 @@ bool ActionNode::start(const std::string & action_name)
   return true;
 }
 
-bool ActionNode::start(const Action & action)
+bool ActionNode::start(int action_id, const ActionTransform & transform)
 {
+  if (action_id < 0 || action_id >= action_manager->get_action_count()) {
+    return false;
+  }
+
   Pose pose = this->initial_pose;
 
   if (!pose.get_joints().empty()) {
-    action_manager->start(action, pose);
+    action_manager->start(action_id, pose, transform);
   } else {
     return false;
   }
@@ -115,26 +621,115 @@ bool ActionNode::start(const Action & action)
   return true;
 }
 
+bool ActionNode::start(const Action & action, const ActionTransform & transform)
+{
+  Pose pose = this->initial_pose;
+
+  if (!pose.get_joints().empty()) {
+    action_manager->start(action, pose, transform);
+  } else {
+    return false;
+  }
+
+  return true;
+}
+
+void ActionNode::post(const std::function<void()> & command)
+{
+  std::lock_guard<std::mutex> lock(command_mutex);
+  commands.push_back(command);
+}
+
 bool ActionNode::update(int time)
 {
+  // the interpolator plays by time, so a skipped tick is caught up on the
+  // next one
+  std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    return true;
+  }
+
+  // commands left behind by a busy queue are applied on the next tick
+  std::vector<std::function<void()>> commands;
+  {
+    std::unique_lock<std::mutex> command_lock(command_mutex, std::try_to_lock);
+    if (command_lock.owns_lock()) {
+      commands.swap(this->commands);
+    }
+  }
+
+  for (const auto & command : commands) {
+    command();
+  }
+
+  if (!action_manager->is_playing() && action_manager->get_queue_size() > 0 &&
+    !initial_pose.get_joints().empty())
+  {
+    action_manager->start_next(initial_pose);
+  }
+
   if (action_manager->is_playing()) {
     action_manager->process(time);
     publish_joints();
 
+    if (input_log) {
+      input_log->write_tick(time, action_manager->get_joints());
+    }
+
     return true;
   }
 
   publish_status();
 
+  if (input_log) {
+    input_log->write_tick(time, {});
+  }
+
   return false;
 }
 
+int ActionNode::get_wakeup_delay(int time) const
+{
+  {
+    std::lock_guard<std::mutex> lock(command_mutex);
+    if (!commands.empty()) {
+      return 0;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  if (!action_manager->is_playing()) {
+    return (action_manager->get_queue_size() > 0) ? 0 : -1;
+  }
+
+  int idle_until = action_manager->get_idle_until();
+  return (idle_until > time) ? idle_until - time : 0;
+}
+
+void ActionNode::set_wakeup_callback(const std::function<void()> & callback)
+{
+  wakeup_callback = callback;
+}
+
+void ActionNode::set_input_log(std::shared_ptr<InputLog> input_log)
+{
+  this->input_log = input_log;
+}
+
+const ActionCache & ActionNode::get_action_cache() const
+{
+  return action_cache;
+}
+
 void ActionNode::publish_joints()
 {
-  auto joints_msg = tachimawari_interfaces::msg::SetJoints();
+  // a unique message is moved to the subscriptions in the same process when
+  // intra-process communication is enabled, and serialized once otherwise
+  auto joints_msg = std::make_unique<tachimawari_interfaces::msg::SetJoints>();
 
   const auto & joints = action_manager->get_joints();
-  auto & joint_msgs = joints_msg.joints;
+  auto & joint_msgs = joints_msg->joints;
 
   joint_msgs.resize(joints.size());
   for (size_t i = 0; i < joints.size() && i < joint_msgs.size(); ++i) {
@@ -142,7 +737,7 @@ void ActionNode::publish_joints()
     joint_msgs[i].position = joints[i].get_position();
   }
 
-  set_joints_publisher->publish(joints_msg);
+  set_joints_publisher->publish(std::move(joints_msg));
 }
 
 void ActionNode::publish_status()
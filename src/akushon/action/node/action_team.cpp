@@ -0,0 +1,76 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "akushon/action/node/action_team.hpp"
+
+#include "akushon/action/node/action_manager.hpp"
+#include "akushon/action/utils/thread_pool.hpp"
+
+namespace akushon
+{
+
+ActionTeam::ActionTeam(int robot_count, int thread_count)
+: action_managers(std::make_shared<std::vector<ActionManager>>(robot_count)),
+  thread_pool(thread_count)
+{
+}
+
+void ActionTeam::load_config(const std::string & path)
+{
+  if (action_managers->empty()) {
+    return;
+  }
+
+  auto & leader = action_managers->front();
+  leader.load_config(path);
+
+  for (auto & action_manager : *action_managers) {
+    action_manager.share_library(leader);
+  }
+}
+
+int ActionTeam::get_robot_count() const
+{
+  return action_managers->size();
+}
+
+std::shared_ptr<ActionManager> ActionTeam::get_action_manager(int robot_index) const
+{
+  // shares the ownership of the whole team while pointing to one of them
+  return std::shared_ptr<ActionManager>(action_managers, &action_managers->at(robot_index));
+}
+
+void ActionTeam::for_each(const std::function<void(int)> & step)
+{
+  thread_pool.parallel_for(action_managers->size(), step);
+}
+
+void ActionTeam::process(int time)
+{
+  for_each([&](int robot_index) {(*action_managers)[robot_index].process(time);});
+}
+
+}  // namespace akushon
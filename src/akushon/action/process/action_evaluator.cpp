@@ -0,0 +1,148 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <vector>
+
+#include "akushon/action/process/action_evaluator.hpp"
+
+#include "akushon/action/model/action.hpp"
+#include "akushon/action/model/pose.hpp"
+#include "akushon/action/process/interpolator.hpp"
+#include "akushon/action/utils/thread_pool.hpp"
+#include "tachimawari/joint/model/joint.hpp"
+
+namespace akushon
+{
+
+ActionEvaluator::ActionEvaluator(
+  const Action & action, const Pose & initial_pose, int time_step, int time_limit)
+: action(action), initial_pose(initial_pose), time_step(time_step), time_limit(time_limit)
+{
+}
+
+Action ActionEvaluator::apply(const Variant & variant) const
+{
+  Action result = action;
+  result.reset();
+
+  for (int i = 0; i < action.get_pose_count(); ++i) {
+    Pose pose = action.get_pose(i);
+
+    if (i < static_cast<int>(variant.speeds.size()) && variant.speeds[i] >= 0.0) {
+      pose.set_speed(variant.speeds[i]);
+    }
+
+    if (i < static_cast<int>(variant.pauses.size()) && variant.pauses[i] >= 0.0) {
+      pose.set_pause(variant.pauses[i]);
+    }
+
+    result.add_pose(pose);
+  }
+
+  if (variant.start_delay >= 0) {
+    result.set_start_delay(variant.start_delay);
+  }
+
+  if (variant.stop_delay >= 0) {
+    result.set_stop_delay(variant.stop_delay);
+  }
+
+  return result;
+}
+
+ActionEvaluator::Metrics ActionEvaluator::evaluate(const Variant & variant) const
+{
+  Metrics metrics;
+  metrics.is_finished = false;
+  metrics.duration = 0;
+  metrics.peak_velocity = 0.0;
+  metrics.peak_acceleration = 0.0;
+  metrics.final_error = 0.0;
+
+  Interpolator interpolator({apply(variant)}, initial_pose);
+
+  std::vector<float> positions;
+  std::vector<float> velocities;
+  for (const auto & joint : interpolator.get_joints()) {
+    positions.push_back(joint.get_position());
+    velocities.push_back(0.0);
+  }
+
+  float period = time_step / 1000.0;
+
+  int time = 0;
+  for (; time <= time_limit; time += time_step) {
+    interpolator.process(time);
+
+    const auto & joints = interpolator.get_joints();
+    for (size_t i = 0; i < joints.size() && i < positions.size(); ++i) {
+      float velocity = (joints[i].get_position() - positions[i]) / period;
+      float acceleration = (velocity - velocities[i]) / period;
+
+      metrics.peak_velocity = std::max(metrics.peak_velocity, std::fabs(velocity));
+      metrics.peak_acceleration = std::max(metrics.peak_acceleration, std::fabs(acceleration));
+
+      positions[i] = joints[i].get_position();
+      velocities[i] = velocity;
+    }
+
+    if (interpolator.is_finished()) {
+      metrics.is_finished = true;
+      break;
+    }
+  }
+
+  metrics.duration = std::min(time, time_limit);
+
+  // a joint ends at the position of the last pose that moves it
+  std::map<uint8_t, float> final_positions;
+  for (const auto & pose : action.get_poses()) {
+    for (const auto & joint : pose.get_joints()) {
+      final_positions[joint.get_id()] = joint.get_position();
+    }
+  }
+
+  for (const auto & joint : interpolator.get_joints()) {
+    auto it = final_positions.find(joint.get_id());
+    if (it != final_positions.end()) {
+      metrics.final_error = std::max(
+        metrics.final_error, std::fabs(joint.get_position() - it->second));
+    }
+  }
+
+  return metrics;
+}
+
+std::vector<ActionEvaluator::Metrics> ActionEvaluator::evaluate(
+  const std::vector<Variant> & variants, ThreadPool & thread_pool) const
+{
+  std::vector<Metrics> results(variants.size());
+
+  thread_pool.parallel_for(
+    variants.size(), [&](int index) {results[index] = evaluate(variants[index]);});
+
+  return results;
+}
+
+}  // namespace akushon
@@ -0,0 +1,283 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "akushon/action/process/duration_estimator.hpp"
+
+#include "akushon/action/model/action_library.hpp"
+#include "akushon/action/model/pose.hpp"
+#include "akushon/action/process/joint_process.hpp"
+#include "tachimawari/joint/model/joint.hpp"
+
+namespace akushon
+{
+
+DurationEstimator::DurationEstimator(
+  std::shared_ptr<const ActionLibrary> library, int time_step)
+: library(library), time_step(time_step)
+{
+}
+
+int DurationEstimator::estimate(int action_id) const
+{
+  return estimate(std::vector<int>{action_id}, nullptr);
+}
+
+int DurationEstimator::estimate(int action_id, const Pose & initial_pose) const
+{
+  return estimate(std::vector<int>{action_id}, &initial_pose);
+}
+
+int DurationEstimator::estimate_chain(int action_id) const
+{
+  auto action_ids = get_chain(action_id);
+  return action_ids.empty() ? -1 : estimate(action_ids, nullptr);
+}
+
+int DurationEstimator::estimate_chain(int action_id, const Pose & initial_pose) const
+{
+  auto action_ids = get_chain(action_id);
+  return action_ids.empty() ? -1 : estimate(action_ids, &initial_pose);
+}
+
+std::vector<int> DurationEstimator::estimate_pose_durations(int action_id) const
+{
+  return estimate_pose_durations(action_id, nullptr);
+}
+
+std::vector<int> DurationEstimator::estimate_pose_durations(
+  int action_id, const Pose & initial_pose) const
+{
+  return estimate_pose_durations(action_id, &initial_pose);
+}
+
+std::vector<int> DurationEstimator::estimate_pose_durations(
+  int action_id, const Pose * initial_pose) const
+{
+  std::vector<int> move_ticks;
+  estimate(std::vector<int>{action_id}, initial_pose, &move_ticks);
+
+  // a pose moving for n ticks reaches its target n - 1 ticks after it starts
+  std::vector<int> durations;
+  for (int ticks : move_ticks) {
+    durations.push_back((ticks - 1) * time_step);
+  }
+
+  return durations;
+}
+
+std::vector<int> DurationEstimator::get_chain(int action_id) const
+{
+  std::vector<int> action_ids;
+  std::vector<bool> visited(library->get_action_count(), false);
+
+  while (action_id >= 0) {
+    if (visited[action_id]) {
+      return {};
+    }
+
+    visited[action_id] = true;
+    action_ids.push_back(action_id);
+    action_id = library->get_action_data(action_id).next_action_id;
+  }
+
+  return action_ids;
+}
+
+int DurationEstimator::estimate(
+  const std::vector<int> & action_ids, const Pose * initial_pose,
+  std::vector<int> * move_ticks_out) const
+{
+  // joints of a known position are stepped like the interpolator does, so a
+  // via blend hands over to the next pose on the same tick as when played
+  std::vector<JointProcess> joint_processes;
+  for (int id = 0; id < ActionLibrary::MAX_JOINTS; ++id) {
+    joint_processes.push_back(JointProcess(id));
+  }
+
+  uint64_t known_mask = 0;
+  uint64_t present_mask = ~uint64_t(0);
+
+  if (initial_pose) {
+    present_mask = 0;
+    for (const auto & joint : initial_pose->get_joints()) {
+      if (joint.get_id() < ActionLibrary::MAX_JOINTS) {
+        present_mask |= (uint64_t(1) << joint.get_id());
+        joint_processes[joint.get_id()] = JointProcess(joint.get_id(), joint.get_position());
+      }
+    }
+
+    known_mask = present_mask;
+  }
+
+  uint64_t moving_mask = 0;
+
+  // ticks are counted from the first process call, a state change made in
+  // one tick is only handled by the next one
+  int tick = 0;
+  for (size_t i = 0; i < action_ids.size(); ++i) {
+    const auto & action_data = library->get_action_data(action_ids[i]);
+
+    int playing_tick = tick + count_wait_ticks(action_data.start_delay) + 1;
+    int stop_tick = playing_tick;
+    bool is_via = false;
+
+    for (uint32_t j = 0; j < action_data.pose_count; ++j) {
+      int pose_index = action_data.first_pose + j;
+      const auto & pose_data = library->get_pose_data(pose_index);
+      const float * targets = library->get_positions(pose_index);
+
+      // the pause of a pose is waited before moving to it, except for the
+      // first pose of the first action which starts right away and a pose
+      // blended into from a via point
+      int pose_tick = stop_tick;
+      if ((i > 0 || j > 0) && !is_via) {
+        pose_tick += count_wait_ticks(pose_data.pause);
+      }
+
+      float speed = std::min(std::max(pose_data.speed, 0.0f), 1.0f);
+      bool is_timed = pose_data.duration >= 0.0;
+
+      // a joint of unknown position is assumed to move from far enough away
+      // to take every step of its speed, or the whole duration when timed
+      int unknown_ticks = 0;
+      int timed_ticks = 1;
+      if (pose_data.duration > 0.0) {
+        timed_ticks = static_cast<int>(std::ceil(pose_data.duration / time_step)) + 1;
+      }
+
+      uint64_t joint_mask = pose_data.joint_mask & present_mask;
+      for (int id = 0; id < library->get_joint_columns(); ++id) {
+        uint64_t bit = uint64_t(1) << id;
+        if (!(joint_mask & bit)) {
+          continue;
+        }
+
+        auto & joint_process = joint_processes[id];
+        if (!(known_mask & bit)) {
+          if (is_timed) {
+            unknown_ticks = std::max(unknown_ticks, timed_ticks);
+          } else if (speed > 0.0) {
+            unknown_ticks = std::max(unknown_ticks, static_cast<int>(std::ceil(1.0 / speed)));
+          }
+
+          joint_process = JointProcess(id, targets[id]);
+          known_mask |= bit;
+          continue;
+        }
+
+        if (is_timed) {
+          joint_process.set_target_duration(targets[id], pose_data.duration, pose_tick * time_step);
+        } else if (is_via) {
+          joint_process.set_via_target_position(targets[id], pose_data.speed);
+        } else {
+          joint_process.set_target_position(targets[id], pose_data.speed);
+        }
+
+        if (static_cast<tachimawari::joint::Joint>(joint_process).get_position() != targets[id]) {
+          moving_mask |= bit;
+        }
+      }
+
+      // the next pose of the same action is started on the way once every
+      // moving joint is within the via distance, unless it pauses first
+      float via = 0.0;
+      if (j + 1 < action_data.pose_count && library->get_pose_data(pose_index + 1).pause <= 0.0) {
+        via = pose_data.via;
+      }
+
+      // the joints move from the tick the pose is started on, and arrival is
+      // noticed on the tick after the last joint reaches its target
+      int move_tick = pose_tick;
+      interpolate(joint_processes, moving_mask, move_tick);
+
+      is_via = false;
+      while (true) {
+        ++move_tick;
+
+        bool is_known = move_tick >= pose_tick + unknown_ticks;
+        if (moving_mask == 0 && is_known) {
+          break;
+        }
+
+        if (via > 0.0 && is_known && is_within(joint_processes, moving_mask, via)) {
+          is_via = true;
+          break;
+        }
+
+        interpolate(joint_processes, moving_mask, move_tick);
+      }
+
+      if (move_ticks_out) {
+        move_ticks_out->push_back(move_tick - pose_tick);
+      }
+
+      stop_tick = move_tick;
+    }
+
+    tick = stop_tick + 1 + count_wait_ticks(action_data.stop_delay);
+
+    if (i + 1 < action_ids.size()) {
+      ++tick;
+    }
+  }
+
+  return tick * time_step;
+}
+
+void DurationEstimator::interpolate(
+  std::vector<JointProcess> & joint_processes, uint64_t & moving_mask, int tick) const
+{
+  for (uint64_t mask = moving_mask; mask != 0; mask &= mask - 1) {
+    int id = __builtin_ctzll(mask);
+
+    joint_processes[id].interpolate(tick * time_step);
+    if (joint_processes[id].is_finished()) {
+      moving_mask &= ~(uint64_t(1) << id);
+    }
+  }
+}
+
+bool DurationEstimator::is_within(
+  const std::vector<JointProcess> & joint_processes, uint64_t moving_mask, float distance) const
+{
+  for (uint64_t mask = moving_mask; mask != 0; mask &= mask - 1) {
+    if (joint_processes[__builtin_ctzll(mask)].get_remaining_distance() > distance) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+int DurationEstimator::count_wait_ticks(float duration) const
+{
+  // a wait ends on the first tick that is strictly past its duration
+  return static_cast<int>(std::floor(duration * 1000 / time_step)) + 1;
+}
+
+}  // namespace akushon
@@ -18,34 +18,111 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "akushon/action/process/interpolator.hpp"
 #include "akushon/action/model/action.hpp"
+#include "akushon/action/model/action_library.hpp"
 #include "akushon/action/process/joint_process.hpp"
 #include "tachimawari/joint/model/joint.hpp"
 
 namespace akushon
 {
 
-Interpolator::Interpolator(const std::vector<Action> & actions, const Pose & initial_pose)
-: actions(actions), joint_processes({}), current_pose_index(0),
+Interpolator::Interpolator(
+  const std::vector<Action> & actions, const Pose & initial_pose,
+  const ActionTransform & transform)
+: Interpolator(nullptr, {}, initial_pose, transform)
+{
+  auto library = std::make_shared<ActionLibrary>();
+
+  for (size_t i = 0; i < actions.size(); ++i) {
+    action_ids.push_back(library->add_action(std::to_string(i), actions[i]));
+  }
+
+  this->library = library;
+  state = (action_ids.size() != 0) ? START_DELAY : END;
+}
+
+Interpolator::Interpolator(
+  std::shared_ptr<const ActionLibrary> library, const std::vector<int> & action_ids,
+  const Pose & initial_pose, const ActionTransform & transform)
+: library(library), action_ids(action_ids), transform(transform), joint_processes({}),
+  current_pose_index(0),
   pause_time(0), init_pause(false), start_stop_time(0), init_state(true),
-  current_action_index(0)
+  current_action_index(0), loop_index(-1), remaining_repeats(0), loop_delays(true),
+  moving_joint_mask(0)
 {
+  std::map<uint8_t, float> initial_positions;
   for (const auto & joint : initial_pose.get_joints()) {
-    auto joint_process = JointProcess(joint.get_id(), joint.get_position());
-    joint_processes.insert({joint.get_id(), joint_process});
+    initial_positions.insert({joint.get_id(), joint.get_position()});
   }
 
-  if (actions.size() != 0) {
+  joint_indices.fill(-1);
+  for (const auto & [id, position] : initial_positions) {
+    if (id < ActionLibrary::MAX_JOINTS) {
+      joint_indices[id] = joint_processes.size();
+    }
+
+    joint_processes.push_back(JointProcess(id, position));
+  }
+
+  if (action_ids.size() != 0) {
     state = START_DELAY;
   } else {
     state = END;
   }
 }
 
+void Interpolator::set_loop(int loop_index, int repeat_count, bool loop_delays)
+{
+  // a loop without any pose would spin without ever reaching a target
+  int pose_count = 0;
+  for (int i = std::max(loop_index, 0); i < static_cast<int>(action_ids.size()); ++i) {
+    pose_count += library->get_action_data(action_ids[i]).pose_count;
+  }
+
+  if (loop_index < 0 || loop_index >= static_cast<int>(action_ids.size()) ||
+    (pose_count == 0 && !loop_delays))
+  {
+    this->loop_index = -1;
+    remaining_repeats = 0;
+    return;
+  }
+
+  this->loop_index = loop_index;
+  this->loop_delays = loop_delays;
+
+  // the first iteration is the one being played
+  remaining_repeats = (repeat_count < 0) ? -1 : std::max(repeat_count - 1, 0);
+}
+
+int Interpolator::get_remaining_repeats() const
+{
+  return remaining_repeats;
+}
+
+bool Interpolator::next_iteration()
+{
+  if (loop_index < 0 || remaining_repeats == 0) {
+    return false;
+  }
+
+  if (remaining_repeats > 0) {
+    --remaining_repeats;
+  }
+
+  current_action_index = loop_index;
+  current_pose_index = 0;
+
+  return true;
+}
+
 void Interpolator::process(int time)
 {
   switch (state) {
@@ -56,7 +133,7 @@ void Interpolator::process(int time)
           start_stop_time = time;
         }
 
-        if ((time - start_stop_time) > (get_current_action().get_start_delay() * 1000)) {
+        if ((time - start_stop_time) > get_start_delay()) {
           change_state(PLAYING);
         }
 
@@ -71,13 +148,29 @@ void Interpolator::process(int time)
             pause_time = time;
           }
 
-          if (current_pose_index == get_current_action().get_pose_count()) {
-            change_state(STOP_DELAY);
+          bool is_last_action = current_action_index + 1 == static_cast<int>(action_ids.size());
+
+          if (current_pose_index == static_cast<int>(get_current_action().pose_count)) {
+            // without loop delays the next iteration starts its first pose on
+            // this very tick
+            if (!loop_delays && is_last_action && next_iteration()) {
+              if (get_current_action().pose_count > 0) {
+                next_pose(time);
+              } else {
+                change_state(START_DELAY);
+              }
+            } else {
+              change_state(STOP_DELAY);
+            }
+
             init_pause = true;
-          } else if ((time - pause_time) > (get_current_pose().get_pause() * 1000)) {
-            next_pose();
+          } else if ((time - pause_time) > get_pause()) {
+            next_pose(time);
             init_pause = true;
           }
+        } else if (check_for_via()) {
+          next_pose(time, true);
+          init_pause = true;
         }
 
         break;
@@ -90,12 +183,15 @@ void Interpolator::process(int time)
           start_stop_time = time;
         }
 
-        if ((time - start_stop_time) > (get_current_action().get_stop_delay() * 1000)) {
+        if ((time - start_stop_time) > get_stop_delay()) {
           ++current_action_index;
 
-          if (current_action_index == actions.size()) {
+          if (current_action_index == static_cast<int>(action_ids.size()) &&
+            !next_iteration())
+          {
             change_state(END);
           } else {
+            current_pose_index = 0;
             change_state(START_DELAY);
           }
         }
@@ -104,8 +200,16 @@ void Interpolator::process(int time)
       }
   }
 
-  for (const auto & [id, joint] : joint_processes) {
-    joint_processes.at(id).interpolate();
+  // settled joints are left untouched, only the moving ones are stepped
+  for (uint64_t mask = moving_joint_mask; mask != 0; mask &= mask - 1) {
+    int id = __builtin_ctzll(mask);
+
+    auto & joint_process = joint_processes[joint_indices[id]];
+    joint_process.interpolate(time);
+
+    if (joint_process.is_finished()) {
+      moving_joint_mask &= ~(uint64_t(1) << id);
+    }
   }
 }
 
@@ -114,13 +218,62 @@ bool Interpolator::is_finished() const
   return state == END;
 }
 
-void Interpolator::next_pose()
+int Interpolator::get_idle_until() const
+{
+  if (moving_joint_mask != 0) {
+    return -1;
+  }
+
+  switch (state) {
+    case START_DELAY:
+      return init_state ? -1 : start_stop_time + get_start_delay();
+
+    case PLAYING:
+      if (init_pause || current_pose_index == static_cast<int>(get_current_action().pose_count)) {
+        return -1;
+      }
+
+      return pause_time + std::floor(get_pause());
+
+    case STOP_DELAY:
+      return init_state ? -1 : start_stop_time + get_stop_delay();
+  }
+
+  return -1;
+}
+
+void Interpolator::next_pose(int time, bool via)
 {
-  auto current_pose = get_current_pose();
-  for (const auto & joint : current_pose.get_joints()) {
-    if (joint_processes.find(joint.get_id()) != joint_processes.end()) {
-      joint_processes.at(joint.get_id()).set_target_position(
-        joint.get_position(), current_pose.get_speed());
+  int pose_index = get_current_pose_index();
+  const auto & pose_data = library->get_pose_data(pose_index);
+  const float * positions = library->get_positions(pose_index);
+
+  // a mirrored joint may read a column of its partner beyond its own
+  int joint_count = transform.is_mirrored() ?
+    ActionLibrary::MAX_JOINTS : library->get_joint_columns();
+  float speed = pose_data.speed * transform.get_time_scale();
+
+  for (int id = 0; id < joint_count; ++id) {
+    if (joint_indices[id] < 0 ||
+      !(pose_data.joint_mask & (uint64_t(1) << transform.get_source_id(id))))
+    {
+      continue;
+    }
+
+    float position = transform.get_position(id, positions);
+
+    auto & joint_process = joint_processes[joint_indices[id]];
+    if (pose_data.duration >= 0.0) {
+      joint_process.set_target_duration(
+        position, pose_data.duration / transform.get_time_scale(), time);
+    } else if (via) {
+      joint_process.set_via_target_position(position, speed);
+    } else {
+      joint_process.set_target_position(position, speed);
+    }
+
+    if (static_cast<tachimawari::joint::Joint>(joint_process).get_position() != position) {
+      moving_joint_mask |= (uint64_t(1) << id);
     }
   }
   ++current_pose_index;
@@ -128,24 +281,55 @@ void Interpolator::next_pose()
 
 bool Interpolator::check_for_next()
 {
-  int joint_number = joint_processes.size();
-  for (const auto & [id, joint] : joint_processes) {
-    if (joint.is_finished()) {
-      --joint_number;
+  return moving_joint_mask == 0;
+}
+
+bool Interpolator::check_for_via()
+{
+  const auto & action = get_current_action();
+  if (current_pose_index == 0 || current_pose_index >= static_cast<int>(action.pose_count)) {
+    return false;
+  }
+
+  float via = library->get_pose_data(action.first_pose + current_pose_index - 1).via;
+  if (via <= 0.0 || library->get_pose_data(get_current_pose_index()).pause > 0.0) {
+    return false;
+  }
+
+  for (uint64_t mask = moving_joint_mask; mask != 0; mask &= mask - 1) {
+    int id = __builtin_ctzll(mask);
+    if (joint_processes[joint_indices[id]].get_remaining_distance() > via) {
+      return false;
     }
   }
 
-  return joint_number <= 0;
+  return true;
 }
 
-const Action & Interpolator::get_current_action() const
+const ActionLibrary::ActionData & Interpolator::get_current_action() const
 {
-  return actions[current_action_index];
+  return library->get_action_data(action_ids[current_action_index]);
 }
 
-const Pose & Interpolator::get_current_pose() const
+int Interpolator::get_current_pose_index() const
 {
-  return get_current_action().get_pose(current_pose_index);
+  return get_current_action().first_pose + current_pose_index;
+}
+
+float Interpolator::get_start_delay() const
+{
+  return get_current_action().start_delay * 1000 / transform.get_time_scale();
+}
+
+float Interpolator::get_stop_delay() const
+{
+  return get_current_action().stop_delay * 1000 / transform.get_time_scale();
+}
+
+float Interpolator::get_pause() const
+{
+  return library->get_pose_data(get_current_pose_index()).pause * 1000 /
+         transform.get_time_scale();
 }
 
 void Interpolator::change_state(int state)
@@ -158,11 +342,35 @@ std::vector<tachimawari::joint::Joint> Interpolator::get_joints() const
 {
   std::vector<tachimawari::joint::Joint> joints;
 
-  for (const auto & [id, joint] : joint_processes) {
-    joints.push_back(joint);
+  for (const auto & joint_process : joint_processes) {
+    joints.push_back(joint_process);
   }
 
   return joints;
 }
 
+const std::vector<JointProcess> & Interpolator::get_joint_processes() const
+{
+  return joint_processes;
+}
+
+int Interpolator::get_state() const
+{
+  return state;
+}
+
+int Interpolator::get_action_id() const
+{
+  if (current_action_index < static_cast<int>(action_ids.size())) {
+    return action_ids[current_action_index];
+  }
+
+  return -1;
+}
+
+int Interpolator::get_pose_index() const
+{
+  return current_pose_index;
+}
+
 }  // namespace akushon
@@ -31,12 +31,15 @@ namespace akushon
 
 JointProcess::JointProcess(uint8_t joint_id, float position)
 : joint(tachimawari::joint::Joint(joint_id, position)), initial_position(position),
-  target_position(position), additional_position(0.0)
+  target_position(position), additional_position(0.0), blend_position(0.0), blend_ticks(0),
+  blend_tick(0), is_timed(false), start_time(0), duration(0.0)
 {
 }
 
 void JointProcess::set_target_position(float target_position, float speed)
 {
+  is_timed = false;
+
   float filtered_speed = (speed > 1.0) ? 1.0 : speed;
   filtered_speed = (filtered_speed < 0.0) ? 0.0 : filtered_speed;
 
@@ -45,30 +48,95 @@ void JointProcess::set_target_position(float target_position, float speed)
   additional_position = (fabs(additional_position) < 0.1) ? 0.0 : additional_position;
 }
 
+void JointProcess::set_via_target_position(float target_position, float speed)
+{
+  float previous_step = is_finished() ? 0.0 : additional_position;
+  float remaining_distance = get_remaining_distance();
+
+  set_initial_position(joint.get_position());
+  set_target_position(target_position, speed);
+
+  blend_position = previous_step;
+  blend_tick = 0;
+  blend_ticks = (previous_step != 0.0 && additional_position != 0.0) ?
+    std::ceil(remaining_distance / fabs(previous_step)) : 0;
+}
+
+void JointProcess::set_target_duration(float target_position, float duration, int time)
+{
+  initial_position = joint.get_position();
+  this->target_position = target_position;
+  additional_position = 0.0;
+  blend_ticks = 0;
+
+  if (duration <= 0.0 || initial_position == target_position) {
+    joint.set_position(target_position);
+    initial_position = target_position;
+    is_timed = false;
+    return;
+  }
+
+  is_timed = true;
+  start_time = time;
+  this->duration = duration;
+}
+
+float JointProcess::get_remaining_distance() const
+{
+  return fabs(target_position - joint.get_position());
+}
+
 void JointProcess::set_initial_position(float initial_position)
 {
   this->initial_position = initial_position;
 }
 
-void JointProcess::interpolate()
+void JointProcess::interpolate(int time)
 {
+  // the position follows the elapsed time, so a tick that comes late does not
+  // slow the move down
+  if (is_timed) {
+    float ratio = (time - start_time) / duration;
+    if (ratio >= 1.0) {
+      joint.set_position(target_position);
+      initial_position = target_position;
+      is_timed = false;
+    } else if (ratio > 0.0) {
+      joint.set_position(initial_position + (target_position - initial_position) * ratio);
+    }
+
+    return;
+  }
+
+  // a via blend eases from the step of the previous target into this one
+  float step = additional_position;
+  if (blend_tick < blend_ticks) {
+    ++blend_tick;
+    step = blend_position + (additional_position - blend_position) * blend_tick / (blend_ticks + 1);
+  }
+
   bool target_position_is_reached = false;
   target_position_is_reached |= (additional_position >= 0 &&
-    (joint.get_position() + additional_position >= target_position));
+    (joint.get_position() + step >= target_position));
   target_position_is_reached |= (additional_position <= 0 &&
-    (joint.get_position() + additional_position < target_position));
+    (joint.get_position() + step < target_position));
 
   if (target_position_is_reached) {
     joint.set_position(target_position);
     additional_position = 0.0;
     initial_position = target_position;
+    blend_ticks = 0;
   } else {
-    joint.set_position(joint.get_position() + additional_position);
+    joint.set_position(joint.get_position() + step);
   }
 }
 
 bool JointProcess::is_finished() const
 {
+  if (is_timed) {
+    return false;
+  }
+
   return (initial_position == target_position) || (additional_position == 0.0);
 }
 
@@ -0,0 +1,300 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "akushon/action/process/teach_recorder.hpp"
+
+#include "akushon/action/model/action.hpp"
+#include "akushon/action/model/pose.hpp"
+#include "tachimawari/joint/model/joint.hpp"
+
+namespace akushon
+{
+
+TeachRecorder::TeachRecorder(int capacity, int time_step)
+: capacity(std::max(capacity, 2)), time_step(time_step), recording(false), sample_count(0)
+{
+  joint_indices.fill(-1);
+}
+
+void TeachRecorder::start(int time, const std::vector<tachimawari::joint::Joint> & joints)
+{
+  joint_ids.clear();
+  joint_indices.fill(-1);
+
+  for (const auto & joint : joints) {
+    if (joint.get_id() < joint_indices.size() && joint_indices[joint.get_id()] < 0) {
+      joint_indices[joint.get_id()] = joint_ids.size();
+      joint_ids.push_back(joint.get_id());
+    }
+  }
+
+  times.assign(capacity, 0);
+  positions.assign(capacity * joint_ids.size(), 0.0);
+
+  sample_count = 0;
+  recording = !joint_ids.empty();
+
+  record(time, joints);
+}
+
+void TeachRecorder::stop()
+{
+  recording = false;
+}
+
+bool TeachRecorder::record(int time, const std::vector<tachimawari::joint::Joint> & joints)
+{
+  if (!recording || is_full()) {
+    return false;
+  }
+
+  float * sample = &positions[sample_count * joint_ids.size()];
+
+  // a joint missing from this message keeps its previous position
+  if (sample_count > 0) {
+    std::copy(sample - joint_ids.size(), sample, sample);
+  }
+
+  for (const auto & joint : joints) {
+    if (joint.get_id() < joint_indices.size() && joint_indices[joint.get_id()] >= 0) {
+      sample[joint_indices[joint.get_id()]] = joint.get_position();
+    }
+  }
+
+  times[sample_count++] = time;
+
+  return true;
+}
+
+bool TeachRecorder::is_recording() const
+{
+  return recording;
+}
+
+bool TeachRecorder::is_full() const
+{
+  return sample_count >= capacity;
+}
+
+int TeachRecorder::get_sample_count() const
+{
+  return sample_count;
+}
+
+Action TeachRecorder::extract(const std::string & action_name, float tolerance, int lead_in) const
+{
+  Action action(action_name);
+  action.set_start_delay(0);
+  action.set_stop_delay(0);
+  action.set_next_action("");
+
+  if (sample_count == 0) {
+    return action;
+  }
+
+  // Douglas-Peucker over time, a sample is only kept when the motion played
+  // linearly between its neighbouring keyframes would miss it
+  std::vector<bool> keyframes(sample_count, false);
+  keyframes.front() = true;
+  keyframes.back() = true;
+
+  std::vector<std::pair<int, int>> segments = {{0, sample_count - 1}};
+  while (!segments.empty()) {
+    auto [first, last] = segments.back();
+    segments.pop_back();
+
+    if (last - first < 2) {
+      continue;
+    }
+
+    int farthest = first + 1;
+    float farthest_deviation = -1.0;
+    for (int i = first + 1; i < last; ++i) {
+      float deviation = get_deviation(first, i, last);
+      if (deviation > farthest_deviation) {
+        farthest = i;
+        farthest_deviation = deviation;
+      }
+    }
+
+    if (farthest_deviation > tolerance) {
+      keyframes[farthest] = true;
+      segments.push_back({first, farthest});
+      segments.push_back({farthest, last});
+    }
+  }
+
+  // the interpolator jumps a joint straight to its target when it would move
+  // less than 0.1 degree per tick, so a long segment is split until such a
+  // jump stays within the tolerance
+  for (int first = 0; first < sample_count - 1; ) {
+    int last = first + 1;
+    while (!keyframes[last]) {
+      ++last;
+    }
+
+    if (last - first >= 2 && get_jump(first, last) > tolerance) {
+      keyframes[(first + last) / 2] = true;
+    } else {
+      first = last;
+    }
+  }
+
+  auto make_pose = [&](int sample, float speed, float pause) {
+      Pose pose("pose_" + std::to_string(action.get_pose_count() + 1));
+
+      std::vector<tachimawari::joint::Joint> joints;
+      for (size_t j = 0; j < joint_ids.size(); ++j) {
+        joints.push_back(tachimawari::joint::Joint(joint_ids[j], get_position(sample, j)));
+      }
+
+      pose.set_joints(joints);
+      pose.set_speed(speed);
+      pose.set_pause(pause);
+
+      return pose;
+    };
+
+  action.add_pose(make_pose(0, 1.0 / get_ticks(lead_in), 0.0));
+
+  // ticks are counted from the arrival at the first pose, every other pose
+  // takes one tick to notice the previous arrival, its pause and its moving
+  // ticks, any rounding is carried over to the next pose so timing never
+  // drifts from the recording
+  int tick = 0;
+  int previous = 0;
+  int latest = 0;
+  for (int i = 1; i < sample_count; ++i) {
+    if (!keyframes[i]) {
+      continue;
+    }
+
+    // a keyframe that does not move extends the hold before the next pose, a
+    // hold at the end is dropped as the joints stay there anyway
+    if (get_movement(previous, i) <= tolerance) {
+      latest = i;
+      continue;
+    }
+
+    int wait_ticks = std::max(1, get_ticks(times[latest] - times[0]) - tick);
+    float pause = (wait_ticks > 1) ?
+      ((wait_ticks - 1) * time_step + time_step / 2) / 1000.0 : 0.0;
+
+    int pose_tick = tick + wait_ticks;
+    int remaining_ticks = get_ticks(times[i] - times[0]) - pose_tick;
+
+    // a speed halfway between two tick counts keeps the float rounding of
+    // each step from adding a tick
+    int ticks = std::max(1, remaining_ticks);
+    float speed = (ticks > 1) ? 1.0 / (ticks - 0.5) : 1.0;
+    int move_ticks = count_move_ticks(previous, i, speed);
+    if (move_ticks > remaining_ticks && ticks > 1) {
+      speed = (ticks > 2) ? 1.0 / (ticks - 1.5) : 1.0;
+      move_ticks = count_move_ticks(previous, i, speed);
+    }
+
+    action.add_pose(make_pose(i, speed, pause));
+
+    tick = pose_tick + move_ticks;
+    previous = i;
+    latest = i;
+  }
+
+  return action;
+}
+
+float TeachRecorder::get_position(int sample, int joint) const
+{
+  return positions[sample * joint_ids.size() + joint];
+}
+
+float TeachRecorder::get_deviation(int first, int sample, int last) const
+{
+  float ratio = (times[last] == times[first]) ? 0.0 :
+    static_cast<float>(times[sample] - times[first]) / (times[last] - times[first]);
+
+  float deviation = 0.0;
+  for (size_t j = 0; j < joint_ids.size(); ++j) {
+    float expected = get_position(first, j) +
+      (get_position(last, j) - get_position(first, j)) * ratio;
+    deviation = std::max(deviation, std::fabs(get_position(sample, j) - expected));
+  }
+
+  return deviation;
+}
+
+int TeachRecorder::get_ticks(int duration) const
+{
+  return std::max(1, static_cast<int>(std::lround(static_cast<float>(duration) / time_step)));
+}
+
+float TeachRecorder::get_jump(int first, int last) const
+{
+  int ticks = get_ticks(times[last] - times[first]);
+
+  float jump = 0.0;
+  for (size_t j = 0; j < joint_ids.size(); ++j) {
+    float distance = std::fabs(get_position(last, j) - get_position(first, j));
+    if (distance / ticks < 0.1) {
+      jump = std::max(jump, distance);
+    }
+  }
+
+  return jump;
+}
+
+int TeachRecorder::count_move_ticks(int first, int last, float speed) const
+{
+  // the same stepping as JointProcess, a joint moving down only stops once
+  // it would pass below its target
+  int move_ticks = 1;
+  for (size_t j = 0; j < joint_ids.size(); ++j) {
+    float delta = get_position(last, j) - get_position(first, j);
+    float additional = delta * speed;
+
+    if (std::fabs(additional) >= 0.1) {
+      float steps = delta / additional;
+      move_ticks = std::max(
+        move_ticks,
+        static_cast<int>((delta < 0.0) ? std::floor(steps) + 1 : std::ceil(steps)));
+    }
+  }
+
+  return move_ticks;
+}
+
+float TeachRecorder::get_movement(int first, int last) const
+{
+  float movement = 0.0;
+  for (size_t j = 0; j < joint_ids.size(); ++j) {
+    movement = std::max(movement, std::fabs(get_position(last, j) - get_position(first, j)));
+  }
+
+  return movement;
+}
+
+}  // namespace akushon
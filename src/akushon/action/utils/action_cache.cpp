@@ -0,0 +1,118 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "akushon/action/utils/action_cache.hpp"
+
+#include "akushon/action/model/action.hpp"
+#include "akushon/action/utils/fnv1a.hpp"
+
+namespace akushon
+{
+
+uint64_t ActionCache::hash(const std::string & name, const std::string & payload)
+{
+  // the length keeps the boundary between the two fields
+  uint64_t name_size = name.size();
+
+  Fnv1a fnv1a;
+  fnv1a.mix(&name_size, sizeof(name_size));
+  fnv1a.mix(name);
+  fnv1a.mix(payload);
+
+  return fnv1a.get_hash();
+}
+
+ActionCache::ActionCache(size_t capacity)
+: capacity(capacity > 0 ? capacity : 1), entries({}), entry_by_key({}), hit_count(0),
+  miss_count(0)
+{
+}
+
+std::shared_ptr<const Action> ActionCache::find(
+  const std::string & name, const std::string & payload)
+{
+  auto it = entry_by_key.find(hash(name, payload));
+
+  // the fields are compared as well, so a hash collision is only a miss
+  if (it == entry_by_key.end() || it->second->name != name || it->second->payload != payload) {
+    ++miss_count;
+    return nullptr;
+  }
+
+  entries.splice(entries.begin(), entries, it->second);
+  ++hit_count;
+
+  return it->second->action;
+}
+
+void ActionCache::insert(
+  const std::string & name, const std::string & payload, std::shared_ptr<const Action> action)
+{
+  uint64_t key = hash(name, payload);
+
+  auto it = entry_by_key.find(key);
+  if (it != entry_by_key.end()) {
+    entries.erase(it->second);
+    entry_by_key.erase(it);
+  }
+
+  if (entries.size() >= capacity) {
+    entry_by_key.erase(entries.back().key);
+    entries.pop_back();
+  }
+
+  entries.push_front({key, name, payload, action});
+  entry_by_key.insert({key, entries.begin()});
+}
+
+void ActionCache::clear()
+{
+  entries.clear();
+  entry_by_key.clear();
+}
+
+size_t ActionCache::get_capacity() const
+{
+  return capacity;
+}
+
+size_t ActionCache::get_size() const
+{
+  return entries.size();
+}
+
+uint64_t ActionCache::get_hit_count() const
+{
+  return hit_count;
+}
+
+uint64_t ActionCache::get_miss_count() const
+{
+  return miss_count;
+}
+
+}  // namespace akushon
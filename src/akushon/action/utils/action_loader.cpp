@@ -0,0 +1,234 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "akushon/action/utils/action_loader.hpp"
+
+#include "nlohmann/json.hpp"
+
+namespace akushon
+{
+
+ActionLoader::ActionLoader(const std::string & path)
+: parsed_count(0), stopping(false)
+{
+  for (const auto & file : std::filesystem::directory_iterator(path)) {
+    if (file.path().extension() != ".json") {
+      continue;
+    }
+
+    Entry entry;
+    entry.path = file.path();
+    entry.size = file.file_size();
+    entry.modified_time = file.last_write_time();
+
+    entries.emplace(file.path().stem(), entry);
+  }
+}
+
+ActionLoader::~ActionLoader()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+
+  if (thread.joinable()) {
+    thread.join();
+  }
+}
+
+const std::map<std::string, ActionLoader::Entry> & ActionLoader::get_entries() const
+{
+  return entries;
+}
+
+void ActionLoader::prefetch(const std::vector<std::string> & priority)
+{
+  std::vector<std::string> rest;
+  for (const auto & [action_name, entry] : entries) {
+    if (std::find(priority.begin(), priority.end(), action_name) == priority.end()) {
+      rest.push_back(action_name);
+    }
+  }
+
+  std::stable_sort(
+    rest.begin(), rest.end(), [this](const std::string & a, const std::string & b) {
+      return entries.at(a).size < entries.at(b).size;
+    });
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for (const auto & action_name : priority) {
+      if (entries.find(action_name) != entries.end()) {
+        queue.push_back(action_name);
+      }
+    }
+
+    queue.insert(queue.end(), rest.begin(), rest.end());
+  }
+
+  if (!thread.joinable()) {
+    thread = std::thread([this]() {work();});
+  }
+}
+
+void ActionLoader::preload(const std::string & action_name)
+{
+  std::set<std::string> visited;
+
+  std::string name = action_name;
+  while (entries.find(name) != entries.end() && visited.insert(name).second) {
+    std::unique_lock<std::mutex> lock(mutex);
+    parsed_condition.wait(lock, [this, &name]() {return !parsing_names.count(name);});
+
+    auto it = parsed_actions.find(name);
+    if (it == parsed_actions.end()) {
+      // already taken, so it is loaded together with the rest of its chain
+      if (claimed_names.count(name)) {
+        return;
+      }
+
+      claimed_names.insert(name);
+      parsing_names.insert(name);
+
+      lock.unlock();
+      auto action_data = parse(name);
+      lock.lock();
+
+      it = parsed_actions.emplace(name, std::move(action_data)).first;
+      parsing_names.erase(name);
+      ++parsed_count;
+
+      parsed_condition.notify_all();
+    }
+
+    const auto & action_data = it->second;
+    if (!action_data || !action_data->is_object() || !action_data->contains("next") ||
+      !(*action_data)["next"].is_string())
+    {
+      return;
+    }
+
+    name = (*action_data)["next"].get<std::string>();
+  }
+}
+
+std::optional<nlohmann::json> ActionLoader::take(const std::string & action_name)
+{
+  if (entries.find(action_name) == entries.end()) {
+    return std::nullopt;
+  }
+
+  std::unique_lock<std::mutex> lock(mutex);
+
+  // the prefetcher or preload() may be in the middle of this very file
+  parsed_condition.wait(
+    lock, [this, &action_name]() {return !parsing_names.count(action_name);});
+
+  auto it = parsed_actions.find(action_name);
+  if (it != parsed_actions.end()) {
+    auto action_data = std::move(it->second);
+    parsed_actions.erase(it);
+
+    return action_data;
+  }
+
+  // claimed so the prefetcher does not parse it a second time
+  claimed_names.insert(action_name);
+
+  lock.unlock();
+  auto action_data = parse(action_name);
+  lock.lock();
+
+  ++parsed_count;
+
+  return action_data;
+}
+
+int ActionLoader::get_parsed_count() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return parsed_count;
+}
+
+std::optional<nlohmann::json> ActionLoader::parse(const std::string & action_name) const
+{
+  auto it = entries.find(action_name);
+  if (it == entries.end()) {
+    return std::nullopt;
+  }
+
+  try {
+    std::ifstream file(it->second.path);
+    return nlohmann::json::parse(file);
+  } catch (nlohmann::json::parse_error & ex) {
+    return std::nullopt;
+  }
+}
+
+void ActionLoader::work()
+{
+  for (size_t i = 0; ; ++i) {
+    std::string action_name;
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+
+      while (i < queue.size() && claimed_names.count(queue[i])) {
+        ++i;
+      }
+
+      if (stopping || i >= queue.size()) {
+        return;
+      }
+
+      action_name = queue[i];
+      claimed_names.insert(action_name);
+      parsing_names.insert(action_name);
+    }
+
+    auto action_data = parse(action_name);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+
+      parsed_actions[action_name] = std::move(action_data);
+      parsing_names.erase(action_name);
+      ++parsed_count;
+    }
+
+    parsed_condition.notify_all();
+  }
+}
+
+}  // namespace akushon
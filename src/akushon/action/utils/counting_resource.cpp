@@ -0,0 +1,65 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <cstddef>
+#include <memory_resource>
+
+#include "akushon/action/utils/counting_resource.hpp"
+
+namespace akushon
+{
+
+CountingResource::CountingResource(std::pmr::memory_resource * upstream)
+: upstream(upstream), allocated_bytes(0), allocation_count(0)
+{
+}
+
+size_t CountingResource::get_allocated_bytes() const
+{
+  return allocated_bytes;
+}
+
+size_t CountingResource::get_allocation_count() const
+{
+  return allocation_count;
+}
+
+void * CountingResource::do_allocate(size_t bytes, size_t alignment)
+{
+  void * pointer = upstream->allocate(bytes, alignment);
+
+  allocated_bytes += bytes;
+  ++allocation_count;
+
+  return pointer;
+}
+
+void CountingResource::do_deallocate(void * pointer, size_t bytes, size_t alignment)
+{
+  upstream->deallocate(pointer, bytes, alignment);
+}
+
+bool CountingResource::do_is_equal(const std::pmr::memory_resource & other) const noexcept
+{
+  return this == &other;
+}
+
+}  // namespace akushon
@@ -0,0 +1,243 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#include "akushon/action/utils/flight_recorder.hpp"
+
+#include "akushon/action/process/interpolator.hpp"
+#include "akushon/action/utils/thread_pool.hpp"
+#include "tachimawari/joint/model/joint.hpp"
+
+namespace akushon
+{
+
+std::atomic<uint64_t> FlightRecorder::dump_request_count(0);
+std::atomic<uint64_t> FlightRecorder::dump_sequence(0);
+
+namespace
+{
+
+// one writer for every recorder of the process, so a dump never blocks the
+// tick that asked for it
+ThreadPool & get_writer()
+{
+  static ThreadPool writer(1);
+  return writer;
+}
+
+// only touched by the writer thread
+std::deque<std::string> & get_written_paths()
+{
+  static std::deque<std::string> written_paths;
+  return written_paths;
+}
+
+}  // namespace
+
+void FlightRecorder::request_dump()
+{
+  ++dump_request_count;
+}
+
+std::vector<FlightRecorder::Record> FlightRecorder::load(const std::string & path)
+{
+  std::ifstream file(path, std::ios::binary);
+
+  Header header;
+  if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+    std::memcmp(header.magic, "AKFR", 4) != 0 || header.record_size != sizeof(Record))
+  {
+    return {};
+  }
+
+  std::vector<Record> records(header.record_count);
+  file.read(reinterpret_cast<char *>(records.data()), records.size() * sizeof(Record));
+  records.resize(file.gcount() / sizeof(Record));
+
+  return records;
+}
+
+FlightRecorder::FlightRecorder(size_t capacity)
+: records(std::max(capacity, size_t(1))), next_index(0), record_count(0),
+  dump_directory(std::filesystem::temp_directory_path()), jump_threshold(0.0),
+  pending_reason(""), seen_dump_request_count(dump_request_count)
+{
+}
+
+void FlightRecorder::set_dump_directory(const std::string & dump_directory)
+{
+  this->dump_directory = dump_directory;
+}
+
+void FlightRecorder::set_jump_threshold(float jump_threshold)
+{
+  this->jump_threshold = jump_threshold;
+}
+
+void FlightRecorder::record(int time, const Interpolator & interpolator)
+{
+  const Record * previous = (record_count > 0) ?
+    &records[(next_index + records.size() - 1) % records.size()] : nullptr;
+
+  // zeroed as a whole, so a dump holds no stale joints or padding
+  Record & record = records[next_index];
+  std::memset(&record, 0, sizeof(record));
+  record.time = time;
+  record.action_id = interpolator.get_action_id();
+  record.pose_index = interpolator.get_pose_index();
+  record.state = interpolator.get_state();
+
+  for (const auto & joint_process : interpolator.get_joint_processes()) {
+    auto joint = static_cast<tachimawari::joint::Joint>(joint_process);
+    if (joint.get_id() >= MAX_JOINTS) {
+      continue;
+    }
+
+    uint32_t bit = uint32_t(1) << joint.get_id();
+    record.joint_mask |= bit;
+    record.positions[joint.get_id()] = joint.get_position();
+
+    if (jump_threshold > 0.0 && previous && (previous->joint_mask & bit) &&
+      std::fabs(joint.get_position() - previous->positions[joint.get_id()]) > jump_threshold)
+    {
+      mark_anomaly("jump");
+    }
+  }
+
+  next_index = (next_index + 1) % records.size();
+  record_count = std::min(record_count + 1, records.size());
+}
+
+void FlightRecorder::mark_anomaly(const std::string & reason)
+{
+  if (pending_reason.empty()) {
+    pending_reason = reason;
+  }
+}
+
+void FlightRecorder::save_pending()
+{
+  uint64_t current_dump_request_count = dump_request_count;
+  if (current_dump_request_count != seen_dump_request_count) {
+    seen_dump_request_count = current_dump_request_count;
+    mark_anomaly("signal");
+  }
+
+  if (!pending_reason.empty()) {
+    save_in_background(pending_reason);
+    pending_reason = "";
+  }
+}
+
+std::string FlightRecorder::save_in_background(const std::string & reason)
+{
+  auto path = get_dump_path(reason);
+
+  get_writer().post(
+    [path, records = get_records()]() {
+      if (!dump(path, records)) {
+        std::cerr << "failed to dump the flight record to " << path << std::endl;
+        return;
+      }
+
+      std::cout << "[ FLIGHT RECORD ] " << path << std::endl;
+
+      auto & written_paths = get_written_paths();
+      written_paths.push_back(path);
+
+      while (written_paths.size() > MAX_DUMPS) {
+        std::error_code error;
+        std::filesystem::remove(written_paths.front(), error);
+        written_paths.pop_front();
+      }
+    });
+
+  return path;
+}
+
+std::string FlightRecorder::save(const std::string & reason)
+{
+  auto path = get_dump_path(reason);
+  return dump(path) ? path : "";
+}
+
+std::string FlightRecorder::get_dump_path(const std::string & reason) const
+{
+  int time = (record_count > 0) ?
+    records[(next_index + records.size() - 1) % records.size()].time : 0;
+
+  std::filesystem::path path(dump_directory);
+  path /= "akushon_flight_" + std::to_string(getpid()) + "_" +
+    std::to_string(dump_sequence++) + "_" + std::to_string(time) + "_" + reason + ".bin";
+
+  return path.string();
+}
+
+bool FlightRecorder::dump(const std::string & path) const
+{
+  return dump(path, get_records());
+}
+
+bool FlightRecorder::dump(const std::string & path, const std::vector<Record> & records)
+{
+  std::ofstream file(path, std::ios::binary);
+
+  Header header;
+  std::memcpy(header.magic, "AKFR", 4);
+  header.version = 1;
+  header.record_size = sizeof(Record);
+  header.record_count = records.size();
+
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  file.write(
+    reinterpret_cast<const char *>(records.data()), records.size() * sizeof(Record));
+
+  return file.good();
+}
+
+std::vector<FlightRecorder::Record> FlightRecorder::get_records() const
+{
+  std::vector<Record> ordered_records;
+  ordered_records.reserve(record_count);
+
+  size_t first_index = (next_index + records.size() - record_count) % records.size();
+  for (size_t i = 0; i < record_count; ++i) {
+    ordered_records.push_back(records[(first_index + i) % records.size()]);
+  }
+
+  return ordered_records;
+}
+
+}  // namespace akushon
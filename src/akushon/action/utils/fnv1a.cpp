@@ -0,0 +1,62 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "akushon/action/utils/fnv1a.hpp"
+
+namespace akushon
+{
+
+uint64_t Fnv1a::hash(const std::string & value)
+{
+  Fnv1a fnv1a;
+  fnv1a.mix(value);
+
+  return fnv1a.get_hash();
+}
+
+Fnv1a::Fnv1a()
+: hash_value(14695981039346656037ull)
+{
+}
+
+void Fnv1a::mix(const void * data, size_t size)
+{
+  auto bytes = static_cast<const unsigned char *>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash_value = (hash_value ^ bytes[i]) * 1099511628211ull;
+  }
+}
+
+void Fnv1a::mix(const std::string & value)
+{
+  mix(value.data(), value.size());
+}
+
+uint64_t Fnv1a::get_hash() const
+{
+  return hash_value;
+}
+
+}  // namespace akushon
@@ -0,0 +1,221 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "akushon/action/utils/input_log.hpp"
+
+#include "akushon/action/utils/fnv1a.hpp"
+#include "tachimawari/joint/model/joint.hpp"
+
+namespace akushon
+{
+
+namespace
+{
+
+const char MAGIC[4] = {'A', 'K', 'I', 'L'};
+const uint32_t VERSION = 1;
+
+template<typename T>
+bool read_value(std::ifstream & file, T & value)
+{
+  return static_cast<bool>(file.read(reinterpret_cast<char *>(&value), sizeof(value)));
+}
+
+bool read_string(std::ifstream & file, std::string & value)
+{
+  uint32_t size;
+  if (!read_value(file, size)) {
+    return false;
+  }
+
+  value.resize(size);
+  return static_cast<bool>(file.read(value.data(), size));
+}
+
+}  // namespace
+
+uint64_t InputLog::hash(const std::vector<tachimawari::joint::Joint> & joints)
+{
+  if (joints.empty()) {
+    return 0;
+  }
+
+  Fnv1a fnv1a;
+  for (const auto & joint : joints) {
+    uint8_t id = joint.get_id();
+    float position = joint.get_position();
+
+    fnv1a.mix(&id, sizeof(id));
+    fnv1a.mix(&position, sizeof(position));
+  }
+
+  return fnv1a.get_hash();
+}
+
+std::vector<InputLog::Event> InputLog::load(const std::string & path)
+{
+  std::ifstream file(path, std::ios::binary);
+
+  char magic[4];
+  uint32_t version;
+  if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(magic)) != 0 ||
+    !read_value(file, version) || version != VERSION)
+  {
+    return {};
+  }
+
+  std::vector<Event> events;
+
+  uint8_t type;
+  while (read_value(file, type)) {
+    Event event;
+    event.type = type;
+    event.time = 0;
+    event.output_hash = 0;
+    event.control_type = 0;
+
+    if (!read_value(file, event.timestamp)) {
+      break;
+    }
+
+    bool is_complete = true;
+    switch (type) {
+      case TICK:
+        {
+          int32_t time;
+          is_complete = read_value(file, time) && read_value(file, event.output_hash);
+          event.time = time;
+          break;
+        }
+
+      case RUN_ACTION:
+      case ENQUEUE_ACTION:
+      case PREEMPT_ACTION:
+      case LAYER_ACTION:
+        {
+          int32_t control_type;
+          is_complete = read_value(file, control_type) &&
+            read_string(file, event.action_name) && read_string(file, event.json);
+          event.control_type = control_type;
+          break;
+        }
+
+      case BRAKE_ACTION:
+        break;
+
+      case CURRENT_JOINTS:
+        {
+          uint16_t count;
+          is_complete = read_value(file, count);
+          for (uint16_t i = 0; is_complete && i < count; ++i) {
+            uint8_t id;
+            float position;
+            is_complete = read_value(file, id) && read_value(file, position);
+            event.joints.push_back(tachimawari::joint::Joint(id, position));
+          }
+          break;
+        }
+
+      default:
+        is_complete = false;
+    }
+
+    // a log cut short by a crash still replays up to its last whole event
+    if (!is_complete) {
+      break;
+    }
+
+    events.push_back(event);
+  }
+
+  return events;
+}
+
+InputLog::InputLog(const std::string & path)
+: file(path, std::ios::binary), start_time(std::chrono::steady_clock::now())
+{
+  file.write(MAGIC, sizeof(MAGIC));
+  write_value(VERSION);
+}
+
+bool InputLog::is_open() const
+{
+  return file.is_open() && file.good();
+}
+
+void InputLog::write_tick(int time, const std::vector<tachimawari::joint::Joint> & outputs)
+{
+  write_header(TICK);
+  write_value(static_cast<int32_t>(time));
+  write_value(hash(outputs));
+}
+
+void InputLog::write_action(
+  int type, int control_type, const std::string & action_name, const std::string & json)
+{
+  write_header(type);
+  write_value(static_cast<int32_t>(control_type));
+  write_string(action_name);
+  write_string(json);
+
+  file.flush();
+}
+
+void InputLog::write_brake_action()
+{
+  write_header(BRAKE_ACTION);
+
+  file.flush();
+}
+
+void InputLog::write_current_joints(const std::vector<tachimawari::joint::Joint> & joints)
+{
+  write_header(CURRENT_JOINTS);
+  write_value(static_cast<uint16_t>(joints.size()));
+  for (const auto & joint : joints) {
+    write_value(static_cast<uint8_t>(joint.get_id()));
+    write_value(static_cast<float>(joint.get_position()));
+  }
+}
+
+void InputLog::write_header(uint8_t type)
+{
+  auto timestamp = std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now() - start_time);
+
+  write_value(type);
+  write_value(static_cast<int64_t>(timestamp.count()));
+}
+
+void InputLog::write_string(const std::string & value)
+{
+  write_value(static_cast<uint32_t>(value.size()));
+  file.write(value.data(), value.size());
+}
+
+}  // namespace akushon
@@ -0,0 +1,163 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include <alloca.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "akushon/action/utils/realtime.hpp"
+
+namespace akushon
+{
+
+bool Realtime::lock_memory(size_t heap_size)
+{
+  if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+    return false;
+  }
+
+  // freed chunks stay in the heap instead of being trimmed or unmapped, so
+  // a later allocation reuses pages that are already resident
+  mallopt(M_TRIM_THRESHOLD, -1);
+  mallopt(M_MMAP_MAX, 0);
+
+  char * heap = static_cast<char *>(malloc(heap_size));
+  if (heap) {
+    long page_size = sysconf(_SC_PAGESIZE);
+    for (size_t i = 0; i < heap_size; i += page_size) {
+      heap[i] = 0;
+    }
+
+    free(heap);
+  }
+
+  return true;
+}
+
+void Realtime::prefault_stack(size_t stack_size)
+{
+  // the volatile buffer keeps the compiler from dropping the writes
+  volatile char * stack = static_cast<volatile char *>(alloca(stack_size));
+
+  long page_size = sysconf(_SC_PAGESIZE);
+  for (size_t i = 0; i < stack_size; i += page_size) {
+    stack[i] = 0;
+  }
+}
+
+bool Realtime::set_scheduler(int priority)
+{
+  sched_param param;
+  std::memset(&param, 0, sizeof(param));
+  param.sched_priority = priority;
+
+  return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+}
+
+bool Realtime::set_affinity(int cpu)
+{
+  if (cpu < 0 || cpu >= CPU_SETSIZE) {
+    return false;
+  }
+
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(cpu, &cpu_set);
+
+  return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+}
+
+Realtime::Status Realtime::check()
+{
+  Status status {false, 0, false, 0, -1};
+
+  // VmLck counts the pages that are locked, in kB
+  std::ifstream file("/proc/self/status");
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.rfind("VmLck:", 0) == 0) {
+      std::istringstream stream(line.substr(6));
+      size_t locked_kb = 0;
+      stream >> locked_kb;
+
+      status.locked_bytes = locked_kb * 1024;
+      status.memory_locked = locked_kb > 0;
+      break;
+    }
+  }
+
+  int policy = 0;
+  sched_param param;
+  if (pthread_getschedparam(pthread_self(), &policy, &param) == 0 && policy == SCHED_FIFO) {
+    status.fifo_scheduler = true;
+    status.priority = param.sched_priority;
+  }
+
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  if (pthread_getaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0 &&
+    CPU_COUNT(&cpu_set) == 1)
+  {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &cpu_set)) {
+        status.cpu = cpu;
+        break;
+      }
+    }
+  }
+
+  return status;
+}
+
+std::string Realtime::to_string(const Status & status)
+{
+  std::ostringstream stream;
+
+  stream << "memory " << (status.memory_locked ? "locked" : "not locked");
+  if (status.memory_locked) {
+    stream << " (" << status.locked_bytes / 1024 << " kB)";
+  }
+
+  stream << ", scheduler ";
+  if (status.fifo_scheduler) {
+    stream << "SCHED_FIFO " << status.priority;
+  } else {
+    stream << "not real-time";
+  }
+
+  stream << ", affinity ";
+  if (status.cpu >= 0) {
+    stream << "cpu " << status.cpu;
+  } else {
+    stream << "not pinned";
+  }
+
+  return stream.str();
+}
+
+}  // namespace akushon
@@ -0,0 +1,163 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "akushon/action/utils/thread_pool.hpp"
+
+namespace akushon
+{
+
+ThreadPool::ThreadPool(int thread_count)
+: job(nullptr), job_count(0), next_index(0), job_generation(0), busy_count(0),
+  stopping(false)
+{
+  if (thread_count <= 0) {
+    thread_count = std::max(static_cast<int>(std::thread::hardware_concurrency()) - 1, 0);
+  }
+
+  for (int i = 0; i < thread_count; ++i) {
+    threads.push_back(std::thread([this]() {this->work();}));
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+
+  job_condition.notify_all();
+
+  for (auto & thread : threads) {
+    thread.join();
+  }
+}
+
+int ThreadPool::get_thread_count() const
+{
+  return threads.size();
+}
+
+void ThreadPool::parallel_for(int count, const std::function<void(int)> & job)
+{
+  if (count <= 0) {
+    return;
+  }
+
+  if (threads.empty() || count == 1) {
+    for (int i = 0; i < count; ++i) {
+      job(i);
+    }
+
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    this->job = &job;
+    job_count = count;
+    next_index = 0;
+    busy_count = threads.size();
+    ++job_generation;
+  }
+
+  job_condition.notify_all();
+  run_jobs();
+
+  std::unique_lock<std::mutex> lock(mutex);
+  done_condition.wait(lock, [this]() {return busy_count == 0;});
+  this->job = nullptr;
+}
+
+void ThreadPool::post(std::function<void()> task)
+{
+  if (threads.empty()) {
+    task();
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    tasks.push_back(std::move(task));
+  }
+
+  job_condition.notify_one();
+}
+
+void ThreadPool::work()
+{
+  uint64_t seen_generation = 0;
+
+  while (true) {
+    std::function<void()> task;
+
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      job_condition.wait(
+        lock, [&]() {
+          return stopping || job_generation != seen_generation || !tasks.empty();
+        });
+
+      // a parallel_for waits for every worker, so it goes before the tasks
+      if (job_generation == seen_generation) {
+        if (tasks.empty()) {
+          return;
+        }
+
+        task = std::move(tasks.front());
+        tasks.pop_front();
+      } else {
+        seen_generation = job_generation;
+      }
+    }
+
+    if (task) {
+      task();
+      continue;
+    }
+
+    run_jobs();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (--busy_count == 0) {
+      done_condition.notify_one();
+    }
+  }
+}
+
+void ThreadPool::run_jobs()
+{
+  for (int i = next_index++; i < job_count; i = next_index++) {
+    (*job)(i);
+  }
+}
+
+}  // namespace akushon
@@ -18,6 +18,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -26,6 +27,7 @@
 #include "akushon/config/utils/config.hpp"
 #include "akushon_interfaces/srv/save_actions.hpp"
 #include "akushon_interfaces/srv/get_actions.hpp"
+#include "nlohmann/json.hpp"
 #include "rclcpp/rclcpp.hpp"
 
 namespace akushon
@@ -34,11 +36,13 @@ namespace akushon
 ConfigNode::ConfigNode(rclcpp::Node::SharedPtr node, const std::string & path)
 : config_util(path)
 {
+  deduplicate_actions = node->declare_parameter<bool>("deduplicate_actions", false);
+
   get_actions_service = node->create_service<GetActions>(
     get_node_prefix() + "/get_actions",
     [this](std::shared_ptr<GetActions::Request> request,
     std::shared_ptr<GetActions::Response> response) {
-      response->json = this->config_util.get_config();
+      response->json = this->config_util.get_config(this->deduplicate_actions);
     }
   );
 
@@ -50,6 +54,55 @@ ConfigNode::ConfigNode(rclcpp::Node::SharedPtr node, const std::string & path)
       response->status = "SAVED";
     }
   );
+
+  list_actions_service = node->create_service<GetActions>(
+    get_node_prefix() + "/list_actions",
+    [this](std::shared_ptr<GetActions::Request> request,
+    std::shared_ptr<GetActions::Response> response) {
+      nlohmann::json actions_list = nlohmann::json::object();
+      for (const auto & [action_name, action_info] : this->config_util.list_actions()) {
+        actions_list[action_name] = {
+          {"size", action_info.size},
+          {"pose_count", action_info.pose_count},
+          {"version", action_info.version},
+        };
+      }
+
+      response->json = actions_list.dump();
+    }
+  );
+
+  // the request json is {"name": ...}, the action is answered in status
+  get_action_service = node->create_service<SaveActions>(
+    get_node_prefix() + "/get_action",
+    [this](std::shared_ptr<SaveActions::Request> request,
+    std::shared_ptr<SaveActions::Response> response) {
+      nlohmann::json options = nlohmann::json::parse(request->json, nullptr, false);
+      std::string action_name = "";
+      if (options.is_object() && options.contains("name") && options["name"].is_string()) {
+        action_name = options["name"].get<std::string>();
+      }
+
+      response->status = this->config_util.get_action(action_name).dump();
+    }
+  );
+
+  // the request json is {"version": ...}, the changes are answered in status
+  get_actions_since_service = node->create_service<SaveActions>(
+    get_node_prefix() + "/get_actions_since",
+    [this](std::shared_ptr<SaveActions::Request> request,
+    std::shared_ptr<SaveActions::Response> response) {
+      nlohmann::json options = nlohmann::json::parse(request->json, nullptr, false);
+      int64_t version = 0;
+      if (options.is_object() && options.contains("version") &&
+        options["version"].is_number_integer())
+      {
+        version = options["version"].get<int64_t>();
+      }
+
+      response->status = this->config_util.get_actions_since(version).dump();
+    }
+  );
 }
 
 std::string ConfigNode::get_node_prefix() const
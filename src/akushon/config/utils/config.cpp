@@ -18,12 +18,20 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <map>
+#include <sstream>
 #include <string>
 
 #include "akushon/action/model/action_name.hpp"
+#include "akushon/action/utils/fnv1a.hpp"
 #include "akushon/config/utils/config.hpp"
 #include "nlohmann/json.hpp"
 
@@ -35,7 +43,7 @@ Config::Config(const std::string & path)
 {
 }
 
-std::string Config::get_config() const
+std::string Config::get_config(bool deduplicate) const
 {
   nlohmann::json actions_list;
   std::cout << "[ ACTIONS LIST ] : " << std::endl;
@@ -58,16 +66,24 @@ std::string Config::get_config() const
     }
   }
   std::cout << std::endl;
-  return actions_list.dump();
+  return deduplicate ? Config::deduplicate(actions_list).dump() : actions_list.dump();
 }
 
 void Config::save_config(const std::string & actions_data)
 {
   nlohmann::json actions_list = nlohmann::json::parse(actions_data);
+  if (actions_list.contains("pose_pool") && actions_list.contains("actions")) {
+    actions_list = expand(actions_list);
+  }
+
   for (const auto & [key, val] : actions_list.items()) {
     std::locale loc;
     std::string action_name = key;
     std::replace(action_name.begin(), action_name.end(), ' ', '_');
+    if (!is_valid_action_name(action_name)) {
+      continue;
+    }
+
     std::string file_name = path + action_name + ".json";
     std::ofstream file;
 
@@ -77,4 +93,175 @@ void Config::save_config(const std::string & actions_data)
   }
 }
 
+std::map<std::string, Config::ActionInfo> Config::list_actions()
+{
+  std::map<std::string, ActionInfo> current_infos;
+
+  for (const auto & action_file : std::filesystem::directory_iterator(path)) {
+    if (action_file.path().extension() != ".json") {
+      continue;
+    }
+
+    std::string action_name = action_file.path().stem();
+
+    ActionInfo action_info;
+    action_info.size = action_file.file_size();
+    action_info.version = get_version(action_file.path());
+    action_info.pose_count = 0;
+
+    auto it = action_infos.find(action_name);
+    if (it != action_infos.end() && it->second.size == action_info.size &&
+      it->second.version == action_info.version)
+    {
+      action_info.pose_count = it->second.pose_count;
+    } else {
+      auto action_data = get_action(action_name);
+      if (action_data.is_object() && action_data.contains("poses")) {
+        action_info.pose_count = action_data["poses"].size();
+      }
+    }
+
+    current_infos[action_name] = action_info;
+  }
+
+  action_infos = current_infos;
+
+  return action_infos;
+}
+
+int64_t Config::get_version(const std::string & file_name)
+{
+  // in nanoseconds since the unix epoch, the file clock of std::filesystem has
+  // no portable epoch in C++17
+  struct stat file_stat;
+  if (stat(file_name.c_str(), &file_stat) != 0) {
+    return 0;
+  }
+
+  return static_cast<int64_t>(file_stat.st_mtim.tv_sec) * 1000000000 + file_stat.st_mtim.tv_nsec;
+}
+
+bool Config::is_valid_action_name(const std::string & action_name)
+{
+  // the name becomes a file name, so it must not reach out of the directory
+  return !action_name.empty() && action_name.find('/') == std::string::npos &&
+         action_name.find("..") == std::string::npos &&
+         action_name.find('\0') == std::string::npos;
+}
+
+nlohmann::json Config::get_action(const std::string & action_name) const
+{
+  if (!is_valid_action_name(action_name)) {
+    return nullptr;
+  }
+
+  std::ifstream file(std::filesystem::path(path) / (action_name + ".json"));
+  if (!file) {
+    return nullptr;
+  }
+
+  try {
+    return nlohmann::json::parse(file);
+  } catch (nlohmann::json::parse_error & ex) {
+    return nullptr;
+  }
+}
+
+nlohmann::json Config::get_actions_since(int64_t version)
+{
+  nlohmann::json changes;
+  changes["version"] = version;
+  changes["names"] = nlohmann::json::array();
+  changes["actions"] = nlohmann::json::object();
+
+  for (const auto & [action_name, action_info] : list_actions()) {
+    changes["names"].push_back(action_name);
+
+    if (action_info.version > version) {
+      changes["actions"][action_name] = get_action(action_name);
+      changes["version"] = std::max(changes["version"].get<int64_t>(), action_info.version);
+    }
+  }
+
+  return changes;
+}
+
+nlohmann::json Config::deduplicate(const nlohmann::json & actions_list)
+{
+  nlohmann::json pose_pool = nlohmann::json::object();
+  nlohmann::json actions = actions_list;
+
+  for (auto & [action_name, action_data] : actions.items()) {
+    if (!action_data.contains("poses")) {
+      continue;
+    }
+
+    for (auto & pose : action_data["poses"]) {
+      if (!pose.contains("joints") || !pose["joints"].is_object()) {
+        continue;
+      }
+
+      // the joints are dumped with sorted keys, so equal poses hash equally
+      std::string joints = pose["joints"].dump();
+
+      std::stringstream key;
+      key << std::hex << std::setw(16) << std::setfill('0') << Fnv1a::hash(joints);
+
+      // on a hash collision the pose simply keeps its own joints
+      auto & pooled_joints = pose_pool[key.str()];
+      if (pooled_joints.is_null()) {
+        pooled_joints = pose["joints"];
+      } else if (pooled_joints != pose["joints"]) {
+        continue;
+      }
+
+      pose["joints"] = key.str();
+    }
+  }
+
+  return {{"pose_pool", pose_pool}, {"actions", actions}};
+}
+
+nlohmann::json Config::expand(const nlohmann::json & deduplicated_list)
+{
+  const auto & pose_pool = deduplicated_list["pose_pool"];
+  nlohmann::json actions = nlohmann::json::object();
+
+  if (!deduplicated_list["actions"].is_object()) {
+    return actions;
+  }
+
+  for (const auto & [action_name, action_data] : deduplicated_list["actions"].items()) {
+    nlohmann::json expanded_data = action_data;
+    bool is_expanded = true;
+
+    if (expanded_data.contains("poses")) {
+      for (auto & pose : expanded_data["poses"]) {
+        if (!pose.contains("joints") || !pose["joints"].is_string()) {
+          continue;
+        }
+
+        // an action referring to a missing pose is left out rather than
+        // saved with a key in place of its joints
+        std::string key = pose["joints"].get<std::string>();
+        if (!pose_pool.is_object() || !pose_pool.contains(key)) {
+          std::cerr << "action " << action_name << " refers to the unknown pose " << key <<
+            std::endl;
+
+          is_expanded = false;
+          break;
+        }
+
+        pose["joints"] = pose_pool[key];
+      }
+    }
+
+    if (is_expanded) {
+      actions[action_name] = expanded_data;
+    }
+  }
+
+  return actions;
+}
+
 }  // namespace akushon
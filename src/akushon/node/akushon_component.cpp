@@ -0,0 +1,58 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "akushon/node/akushon_component.hpp"
+
+#include "akushon/node/akushon_node.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp_components/register_node_macro.hpp"
+
+namespace akushon
+{
+
+AkushonComponent::AkushonComponent(const rclcpp::NodeOptions & options)
+: node(std::make_shared<rclcpp::Node>(
+      "akushon_node", rclcpp::NodeOptions(options).use_intra_process_comms(true)))
+{
+  akushon_node = std::make_shared<AkushonNode>(node);
+
+  std::string path = node->declare_parameter<std::string>("path", "");
+  if (path.empty()) {
+    std::cerr << "Please specify the path parameter!" << std::endl;
+    return;
+  }
+
+  akushon_node->run_action_manager(akushon_node->load_action_manager(path));
+  akushon_node->run_config_service(path);
+}
+
+rclcpp::node_interfaces::NodeBaseInterface::SharedPtr
+AkushonComponent::get_node_base_interface() const
+{
+  return node->get_node_base_interface();
+}
+
+}  // namespace akushon
+
+RCLCPP_COMPONENTS_REGISTER_NODE(akushon::AkushonComponent)
@@ -18,15 +18,22 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
+#include <time.h>
+
+#include <algorithm>
 #include <chrono>
+#include <iostream>
 #include <memory>
 #include <string>
 #include <thread>
 
 #include "akushon/node/akushon_node.hpp"
 
+#include "akushon/action/model/action_name.hpp"
 #include "akushon/action/node/action_manager.hpp"
 #include "akushon/action/node/action_node.hpp"
+#include "akushon/action/utils/input_log.hpp"
+#include "akushon/action/utils/realtime.hpp"
 #include "rclcpp/rclcpp.hpp"
 #include "rclcpp_action/rclcpp_action.hpp"
 
@@ -35,24 +42,185 @@ using namespace std::chrono_literals;
 namespace akushon
 {
 
+std::string AkushonNode::step_topic() {return "akushon/step";}
+
 AkushonNode::AkushonNode(rclcpp::Node::SharedPtr node)
 : node(node), action_node(nullptr), config_node(nullptr),
-  start_time(node->now().seconds())
-{
-  node_timer = node->create_wall_timer(
-    8ms,
-    [this]() {
-      if (this->action_node) {
-        double time = this->node->now().seconds() - this->start_time;
-        this->action_node->update(time * 1000);
-      }
+  start_time(node->now().seconds()), wakeup_timer(nullptr), step_count(0),
+  motion_running(false)
+{
+  tickless = node->declare_parameter<bool>("tickless", false);
+  lockstep = node->declare_parameter<std::string>("lockstep", "off");
+  input_log_path = node->declare_parameter<std::string>("input_log", "");
+
+  realtime = node->declare_parameter<bool>("realtime", false);
+  realtime_priority = node->declare_parameter<int>("realtime_priority", 80);
+  realtime_cpu = node->declare_parameter<int>("realtime_cpu", -1);
+
+  if (realtime) {
+    // locked before the executor and the motion thread are started, so their
+    // stacks are locked as well
+    if (!Realtime::lock_memory(64 * 1024 * 1024)) {
+      std::cerr << "[ REALTIME ] failed to lock memory" << std::endl;
     }
-  );
+  }
+
+  if (lockstep == "clock") {
+    // each simulator clock message is one step at the simulated time
+    clock_subscriber = node->create_subscription<Clock>(
+      "/clock", 10, [this](const Clock::SharedPtr message) {
+        double time = message->clock.sec + message->clock.nanosec * 1e-9;
+        if (this->step_count++ == 0) {
+          this->start_time = time;
+        }
+
+        this->update((time - this->start_time) * 1000);
+      });
+  } else if (lockstep == "trigger") {
+    // each trigger message is one step of 8 ms in virtual time
+    step_subscriber = node->create_subscription<Empty>(
+      step_topic(), 10, [this](const Empty::SharedPtr message) {
+        this->update(this->step_count++ * 8);
+      });
+  } else if (!realtime) {
+    node_timer = node->create_wall_timer(8ms, [this]() {this->update();});
+  }
+}
+
+AkushonNode::~AkushonNode()
+{
+  motion_running = false;
+
+  if (motion_thread.joinable()) {
+    motion_thread.join();
+  }
+}
+
+std::shared_ptr<ActionManager> AkushonNode::load_action_manager(const std::string & path)
+{
+  auto action_manager = std::make_shared<ActionManager>();
+
+  // a lazy start only indexes the files, the actions needed first are
+  // prefetched ahead of the rest
+  if (node->declare_parameter<bool>("lazy_load", false)) {
+    action_manager->index_config(path);
+    action_manager->prefetch(
+      {
+        ActionName::WALKREADY, ActionName::FORWARD_UP, ActionName::BACKWARD_UP,
+        ActionName::LEFTWARD_UP, ActionName::RIGHTWARD_UP,
+      });
+  } else {
+    action_manager->load_config(path);
+  }
+
+  auto library = action_manager->get_library();
+  auto memory_status = library->get_memory_status();
+
+  std::cout << "[ ACTION LIBRARY ] generation " << memory_status.generation << " : " <<
+    library->get_action_count() << " actions, " << memory_status.used_bytes << " of " <<
+    memory_status.reserved_bytes << " bytes in " << memory_status.allocation_count <<
+    " allocations" << std::endl;
+
+  int position_count = std::max(library->get_position_count(), 1);
+  std::cout << "[ ACTION LIBRARY ] " << library->get_pose_count() << " poses share " <<
+    library->get_position_count() << " distinct positions, dedup ratio " <<
+    static_cast<double>(library->get_pose_count()) / position_count << std::endl;
+
+  return action_manager;
 }
 
 void AkushonNode::run_action_manager(std::shared_ptr<ActionManager> action_manager)
 {
   action_node = std::make_shared<ActionNode>(node, action_manager);
+
+  if (!input_log_path.empty()) {
+    action_node->set_input_log(std::make_shared<InputLog>(input_log_path));
+  }
+
+  if (tickless && node_timer) {
+    action_node->set_wakeup_callback([this]() {this->wakeup();});
+  }
+
+  if (realtime && lockstep == "off" && !motion_thread.joinable()) {
+    motion_running = true;
+    motion_thread = std::thread([this]() {this->run_motion_loop();});
+  }
+}
+
+void AkushonNode::run_motion_loop()
+{
+  Realtime::prefault_stack(256 * 1024);
+
+  if (!Realtime::set_scheduler(realtime_priority)) {
+    std::cerr << "[ REALTIME ] failed to set SCHED_FIFO " << realtime_priority << std::endl;
+  }
+
+  if (realtime_cpu >= 0 && !Realtime::set_affinity(realtime_cpu)) {
+    std::cerr << "[ REALTIME ] failed to pin to cpu " << realtime_cpu << std::endl;
+  }
+
+  std::cout << "[ REALTIME ] " << Realtime::to_string(Realtime::check()) << std::endl;
+
+  timespec deadline;
+  clock_gettime(CLOCK_MONOTONIC, &deadline);
+
+  while (motion_running && rclcpp::ok()) {
+    deadline.tv_nsec += 8000000;
+    if (deadline.tv_nsec >= 1000000000) {
+      deadline.tv_nsec -= 1000000000;
+      ++deadline.tv_sec;
+    }
+
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr);
+
+    update();
+  }
+}
+
+void AkushonNode::update()
+{
+  if (!action_node) {
+    return;
+  }
+
+  int time = (node->now().seconds() - start_time) * 1000;
+  update(time);
+
+  if (!tickless || !node_timer) {
+    return;
+  }
+
+  int wakeup_delay = action_node->get_wakeup_delay(time);
+  if (wakeup_delay < 0) {
+    // nothing is playing, sleep until the next command
+    node_timer->cancel();
+  } else if (wakeup_delay >= 8) {
+    // skip the ticks of a delay or pause, but wake on the 8 ms grid right
+    // after it ends so the next state change lands on the same tick
+    node_timer->cancel();
+
+    auto wakeup_period = std::chrono::milliseconds((wakeup_delay / 8 + 1) * 8);
+    wakeup_timer = node->create_wall_timer(wakeup_period, [this]() {this->wakeup();});
+  }
+}
+
+void AkushonNode::update(int time)
+{
+  if (action_node) {
+    action_node->update(time);
+  }
+}
+
+void AkushonNode::wakeup()
+{
+  if (wakeup_timer) {
+    wakeup_timer->cancel();
+  }
+
+  if (node_timer->is_canceled()) {
+    node_timer->reset();
+    update();
+  }
 }
 
 void AkushonNode::run_config_service(const std::string & path)
@@ -18,11 +18,13 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
+#include <csignal>
 #include <memory>
 #include <iostream>
 #include <string>
 
 #include "akushon/action/node/action_manager.hpp"
+#include "akushon/action/utils/flight_recorder.hpp"
 #include "akushon/node/akushon_node.hpp"
 #include "rclcpp/rclcpp.hpp"
 
@@ -38,11 +40,11 @@ int main(int argc, char * argv[])
   auto node = std::make_shared<rclcpp::Node>("akushon_node");
   auto akushon_node = std::make_shared<akushon::AkushonNode>(node);
 
-  auto action_manager = std::make_shared<akushon::ActionManager>();
-
   std::string path = argv[1];
+  auto action_manager = akushon_node->load_action_manager(path);
 
-  action_manager->load_config(path);
+  // kill -USR1 dumps the flight record on the next tick
+  std::signal(SIGUSR1, [](int) {akushon::FlightRecorder::request_dump();});
 
   akushon_node->run_action_manager(action_manager);
   akushon_node->run_config_service(path);
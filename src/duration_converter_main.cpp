@@ -0,0 +1,49 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include <iostream>
+#include <string>
+
+#include "akushon/action/node/action_manager.hpp"
+#include "nlohmann/json.hpp"
+
+int main(int argc, char * argv[])
+{
+  if (argc < 3) {
+    std::cerr << "Please specify the path and the action name!" << std::endl;
+    return 0;
+  }
+
+  akushon::ActionManager action_manager;
+  action_manager.load_config(argv[1]);
+
+  int action_id = action_manager.get_action_id(argv[2]);
+  if (action_id < 0) {
+    std::cerr << "the action " << argv[2] << " not found" << std::endl;
+    return 1;
+  }
+
+  // the converted action keeps its speeds, which are ignored once a pose has
+  // a duration
+  auto action = action_manager.convert_to_duration(action_id);
+  std::cout << action_manager.dump_action(action).dump(2) << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,154 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "akushon/action/process/interpolator.hpp"
+#include "akushon/action/utils/flight_recorder.hpp"
+#include "nlohmann/json.hpp"
+
+using Record = akushon::FlightRecorder::Record;
+
+std::string state_name(int state)
+{
+  switch (state) {
+    case akushon::Interpolator::START_DELAY: return "START_DELAY";
+    case akushon::Interpolator::PLAYING: return "PLAYING";
+    case akushon::Interpolator::STOP_DELAY: return "STOP_DELAY";
+    case akushon::Interpolator::END: return "END";
+  }
+
+  return "UNKNOWN";
+}
+
+void print_csv(const std::vector<Record> & records)
+{
+  uint32_t joint_mask = 0;
+  for (const auto & record : records) {
+    joint_mask |= record.joint_mask;
+  }
+
+  std::cout << "time,action,pose,state";
+  for (int id = 0; id < akushon::FlightRecorder::MAX_JOINTS; ++id) {
+    if (joint_mask & (uint32_t(1) << id)) {
+      std::cout << ",joint_" << id;
+    }
+  }
+  std::cout << "\n";
+
+  for (const auto & record : records) {
+    std::cout << record.time << "," << record.action_id << "," << record.pose_index << "," <<
+      state_name(record.state);
+
+    for (int id = 0; id < akushon::FlightRecorder::MAX_JOINTS; ++id) {
+      if (joint_mask & (uint32_t(1) << id)) {
+        std::cout << ",";
+        if (record.joint_mask & (uint32_t(1) << id)) {
+          std::cout << record.positions[id];
+        }
+      }
+    }
+    std::cout << "\n";
+  }
+}
+
+// chrome://tracing format, a span for every run of ticks with the same state,
+// action and pose and a counter track per joint
+void print_trace(const std::vector<Record> & records)
+{
+  nlohmann::json events = nlohmann::json::array();
+
+  size_t begin = 0;
+  for (size_t i = 1; i <= records.size(); ++i) {
+    if (i < records.size() && records[i].state == records[begin].state &&
+      records[i].action_id == records[begin].action_id &&
+      records[i].pose_index == records[begin].pose_index)
+    {
+      continue;
+    }
+
+    const auto & record = records[begin];
+    int end_time = (i < records.size()) ? records[i].time : records[i - 1].time;
+
+    events.push_back(
+      {
+        {"name", state_name(record.state)},
+        {"ph", "X"},
+        {"ts", static_cast<int64_t>(record.time) * 1000},
+        {"dur", static_cast<int64_t>(end_time - record.time) * 1000},
+        {"pid", 0},
+        {"tid", 0},
+        {"args", {{"action", record.action_id}, {"pose", record.pose_index}}},
+      });
+
+    begin = i;
+  }
+
+  for (const auto & record : records) {
+    nlohmann::json positions = nlohmann::json::object();
+    for (int id = 0; id < akushon::FlightRecorder::MAX_JOINTS; ++id) {
+      if (record.joint_mask & (uint32_t(1) << id)) {
+        positions["joint_" + std::to_string(id)] = record.positions[id];
+      }
+    }
+
+    events.push_back(
+      {
+        {"name", "joints"},
+        {"ph", "C"},
+        {"ts", static_cast<int64_t>(record.time) * 1000},
+        {"pid", 0},
+        {"args", positions},
+      });
+  }
+
+  std::cout << nlohmann::json({{"traceEvents", events}}).dump() << std::endl;
+}
+
+int main(int argc, char * argv[])
+{
+  if (argc < 2) {
+    std::cerr << "Please specify the flight record path!" << std::endl;
+    return 0;
+  }
+
+  std::string format = (argc > 2) ? argv[2] : "csv";
+
+  auto records = akushon::FlightRecorder::load(argv[1]);
+  if (records.empty()) {
+    std::cerr << "the flight record is empty or invalid" << std::endl;
+    return 1;
+  }
+
+  if (format == "csv") {
+    print_csv(records);
+  } else if (format == "trace") {
+    print_trace(records);
+  } else {
+    std::cerr << "unknown format " << format << ", use csv or trace" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,201 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include <time.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "akushon/action/model/action_name.hpp"
+#include "akushon/action/model/pose.hpp"
+#include "akushon/action/node/action_manager.hpp"
+#include "akushon/action/utils/realtime.hpp"
+#include "tachimawari/joint/model/joint.hpp"
+#include "tachimawari/joint/model/joint_id.hpp"
+
+// Measures how late the 8 ms motion loop wakes up while other threads load
+// every cpu and churn memory, to compare the default and the real-time mode.
+// usage: jitter <path> [--seconds n] [--realtime] [--priority n] [--cpu n] [--no-stress]
+
+int64_t to_ns(const timespec & time)
+{
+  return static_cast<int64_t>(time.tv_sec) * 1000000000 + time.tv_nsec;
+}
+
+int main(int argc, char * argv[])
+{
+  if (argc < 2) {
+    std::cerr << "Please specify the path!" << std::endl;
+    return 0;
+  }
+
+  std::string path = argv[1];
+  int seconds = 10;
+  bool realtime = false;
+  int priority = 80;
+  int cpu = -1;
+  bool stress = true;
+
+  for (int i = 2; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--seconds" && i + 1 < argc) {
+      seconds = std::atoi(argv[++i]);
+    } else if (arg == "--realtime") {
+      realtime = true;
+    } else if (arg == "--priority" && i + 1 < argc) {
+      priority = std::atoi(argv[++i]);
+    } else if (arg == "--cpu" && i + 1 < argc) {
+      cpu = std::atoi(argv[++i]);
+    } else if (arg == "--no-stress") {
+      stress = false;
+    }
+  }
+
+  if (realtime && !akushon::Realtime::lock_memory(64 * 1024 * 1024)) {
+    std::cerr << "[ REALTIME ] failed to lock memory" << std::endl;
+  }
+
+  akushon::ActionManager action_manager;
+  action_manager.load_config(path);
+
+  int action_id = action_manager.get_action_id(akushon::ActionName::WALKREADY);
+  if (action_id < 0) {
+    std::cerr << "action " << akushon::ActionName::WALKREADY << " is not found" << std::endl;
+    return 1;
+  }
+
+  akushon::Pose initial_pose("initial_pose");
+  {
+    std::vector<tachimawari::joint::Joint> joints;
+    for (auto id : tachimawari::joint::JointId::list) {
+      joints.push_back(tachimawari::joint::Joint(id, 0.0));
+    }
+
+    initial_pose.set_joints(joints);
+  }
+
+  // a spinning thread per cpu and one that keeps mapping and touching fresh
+  // memory, which evicts caches and makes the kernel reclaim pages
+  std::atomic<bool> stressing(stress);
+  std::vector<std::thread> stress_threads;
+  if (stress) {
+    int cpu_count = std::max(1u, std::thread::hardware_concurrency());
+    for (int i = 0; i < cpu_count; ++i) {
+      stress_threads.emplace_back(
+        [&stressing]() {
+          volatile uint64_t value = 0;
+          while (stressing) {
+            ++value;
+          }
+        });
+    }
+
+    stress_threads.emplace_back(
+      [&stressing]() {
+        while (stressing) {
+          std::vector<char> memory(32 * 1024 * 1024);
+          std::memset(memory.data(), 1, memory.size());
+        }
+      });
+  }
+
+  std::vector<int64_t> latencies;
+
+  std::thread motion_thread(
+    [&]() {
+      if (realtime) {
+        akushon::Realtime::prefault_stack(256 * 1024);
+        akushon::Realtime::set_scheduler(priority);
+        if (cpu >= 0) {
+          akushon::Realtime::set_affinity(cpu);
+        }
+      }
+
+      std::cout << "[ REALTIME ] " <<
+        akushon::Realtime::to_string(akushon::Realtime::check()) << std::endl;
+
+      int tick_count = seconds * 125;
+      latencies.reserve(tick_count);
+
+      timespec deadline;
+      clock_gettime(CLOCK_MONOTONIC, &deadline);
+
+      for (int tick = 0; tick < tick_count; ++tick) {
+        deadline.tv_nsec += 8000000;
+        if (deadline.tv_nsec >= 1000000000) {
+          deadline.tv_nsec -= 1000000000;
+          ++deadline.tv_sec;
+        }
+
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr);
+
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        latencies.push_back(to_ns(now) - to_ns(deadline));
+
+        // the same work as a real tick, restarting the action when it ends
+        if (!action_manager.is_playing()) {
+          action_manager.start(action_id, initial_pose);
+        }
+
+        action_manager.process(tick * 8);
+        action_manager.get_joints();
+      }
+    });
+
+  motion_thread.join();
+
+  stressing = false;
+  for (auto & thread : stress_threads) {
+    thread.join();
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+
+  int64_t total = 0;
+  int missed_count = 0;
+  for (auto latency : latencies) {
+    total += latency;
+    if (latency > 8000000) {
+      ++missed_count;
+    }
+  }
+
+  auto percentile = [&](double fraction) {
+      return latencies[std::min<size_t>(latencies.size() - 1, latencies.size() * fraction)];
+    };
+
+  std::cout << "ticks " << latencies.size() << ", stress " << (stress ? "on" : "off") <<
+    ", mode " << (realtime ? "real-time" : "default") << std::endl;
+  std::cout << "wakeup latency us: min " << latencies.front() / 1000 << ", mean " <<
+    total / static_cast<int64_t>(latencies.size()) / 1000 << ", p99 " <<
+    percentile(0.99) / 1000 << ", p99.9 " << percentile(0.999) / 1000 << ", max " <<
+    latencies.back() / 1000 << std::endl;
+  std::cout << "missed ticks " << missed_count << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,127 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "akushon/action/node/action_manager.hpp"
+#include "akushon/action/node/action_node.hpp"
+#include "akushon/action/utils/input_log.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+int main(int argc, char * argv[])
+{
+  rclcpp::init(argc, argv);
+
+  if (argc < 3) {
+    std::cerr << "Please specify the path and the input log!" << std::endl;
+    return 0;
+  }
+
+  auto events = akushon::InputLog::load(argv[2]);
+  if (events.empty()) {
+    std::cerr << "the input log is empty or invalid" << std::endl;
+    return 1;
+  }
+
+  auto action_manager = std::make_shared<akushon::ActionManager>();
+  action_manager->load_config(argv[1]);
+
+  // the node is never spun, every input comes from the log in virtual time,
+  // its own namespace keeps the replayed joints away from a running robot
+  auto node = std::make_shared<rclcpp::Node>("akushon_replay", "akushon_replay");
+  auto action_node = std::make_shared<akushon::ActionNode>(node, action_manager);
+
+  std::cerr << "[ REPLAY ] joints and status are published under " <<
+    node->get_namespace() << ", do not remap it onto a live joint node" << std::endl;
+
+  int tick_count = 0;
+  int mismatch_count = 0;
+
+  auto start_time = std::chrono::steady_clock::now();
+
+  for (const auto & event : events) {
+    switch (event.type) {
+      case akushon::InputLog::TICK:
+        {
+          ++tick_count;
+
+          bool is_playing = action_node->update(event.time);
+          uint64_t output_hash = is_playing ?
+            akushon::InputLog::hash(action_manager->get_joints()) : 0;
+
+          if (output_hash != event.output_hash) {
+            if (mismatch_count == 0) {
+              std::cout << "first mismatch at " << event.time << " ms (" <<
+                event.timestamp << " us into the log)" << std::endl;
+            }
+
+            ++mismatch_count;
+          }
+          break;
+        }
+
+      case akushon::InputLog::RUN_ACTION:
+      case akushon::InputLog::ENQUEUE_ACTION:
+      case akushon::InputLog::PREEMPT_ACTION:
+      case akushon::InputLog::LAYER_ACTION:
+        {
+          akushon::ActionNode::RunAction message;
+          message.control_type = event.control_type;
+          message.action_name = event.action_name;
+          message.json = event.json;
+
+          if (event.type == akushon::InputLog::ENQUEUE_ACTION) {
+            action_node->enqueue_action(message);
+          } else if (event.type == akushon::InputLog::PREEMPT_ACTION) {
+            action_node->preempt_action(message);
+          } else if (event.type == akushon::InputLog::LAYER_ACTION) {
+            action_node->layer_action(message);
+          } else {
+            action_node->run_action(message);
+          }
+          break;
+        }
+
+      case akushon::InputLog::BRAKE_ACTION:
+        action_node->brake();
+        break;
+
+      case akushon::InputLog::CURRENT_JOINTS:
+        action_node->set_current_joints(event.joints);
+        break;
+    }
+  }
+
+  auto replay_time = std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now() - start_time);
+
+  std::cout << "[ REPLAY ] " << events.size() << " events, " << tick_count << " ticks, " <<
+    mismatch_count << " mismatched outputs, " << events.back().timestamp / 1000 <<
+    " ms recorded in " << replay_time.count() / 1000.0 << " ms" << std::endl;
+
+  rclcpp::shutdown();
+
+  return (mismatch_count == 0) ? 0 : 1;
+}
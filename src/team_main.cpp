@@ -0,0 +1,84 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "akushon/action/node/action_manager.hpp"
+#include "akushon/action/node/action_node.hpp"
+#include "akushon/action/node/action_team.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+using namespace std::chrono_literals;
+
+int main(int argc, char * argv[])
+{
+  rclcpp::init(argc, argv);
+
+  if (argc < 3) {
+    std::cerr << "Please specify the path and the number of robots!" << std::endl;
+    return 0;
+  }
+
+  std::string path = argv[1];
+  int robot_count = std::stoi(argv[2]);
+  int thread_count = (argc > 3) ? std::stoi(argv[3]) : 0;
+
+  akushon::ActionTeam action_team(robot_count, thread_count);
+  action_team.load_config(path);
+
+  auto node = std::make_shared<rclcpp::Node>("akushon_team_node");
+
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node);
+
+  // each robot gets its own namespace, so the topics of robot_n are resolved
+  // under /robot_n just like when it runs in its own process
+  std::vector<rclcpp::Node::SharedPtr> robot_nodes;
+  std::vector<std::shared_ptr<akushon::ActionNode>> action_nodes;
+  for (int i = 0; i < action_team.get_robot_count(); ++i) {
+    auto robot_node = std::make_shared<rclcpp::Node>(
+      "akushon_node", "robot_" + std::to_string(i));
+    auto action_manager = action_team.get_action_manager(i);
+
+    action_nodes.push_back(std::make_shared<akushon::ActionNode>(robot_node, action_manager));
+    robot_nodes.push_back(robot_node);
+    executor.add_node(robot_node);
+  }
+
+  double start_time = node->now().seconds();
+  auto node_timer = node->create_wall_timer(
+    8ms,
+    [&]() {
+      double time = node->now().seconds() - start_time;
+      action_team.for_each(
+        [&](int robot_index) {action_nodes[robot_index]->update(time * 1000);});
+    }
+  );
+
+  executor.spin();
+  rclcpp::shutdown();
+
+  return 0;
+}
@@ -0,0 +1,162 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "akushon/action/utils/action_loader.hpp"
+#include "nlohmann/json.hpp"
+
+namespace
+{
+
+using akushon::ActionLoader;
+
+constexpr int ACTION_COUNT = 12;
+
+class ActionLoaderTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    const auto * test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+    path = std::filesystem::temp_directory_path() /
+      ("akushon_" + std::string(test_info->name()) + "_" + std::to_string(getpid()));
+    std::filesystem::create_directories(path);
+
+    // a chain of actions, each one a little larger than the one before
+    for (int i = 0; i < ACTION_COUNT; ++i) {
+      nlohmann::json action_data;
+      action_data["name"] = get_name(i);
+      action_data["next"] = (i + 1 < ACTION_COUNT) ? get_name(i + 1) : "";
+      action_data["poses"] = std::vector<int>(i * 10, i);
+
+      write(get_name(i) + ".json", action_data.dump());
+    }
+
+    write("notes.txt", "not an action");
+  }
+
+  void TearDown() override
+  {
+    std::filesystem::remove_all(path);
+  }
+
+  std::string get_name(int i) const
+  {
+    return "action_" + std::to_string(i);
+  }
+
+  void write(const std::string & file_name, const std::string & content) const
+  {
+    std::ofstream file(path / file_name);
+    file << content;
+  }
+
+  std::filesystem::path path;
+};
+
+TEST_F(ActionLoaderTest, IndexesOnlyActionFiles)
+{
+  ActionLoader action_loader(path);
+
+  EXPECT_EQ(action_loader.get_entries().size(), ACTION_COUNT);
+  EXPECT_EQ(action_loader.get_entries().count("notes"), 0);
+  EXPECT_EQ(action_loader.get_parsed_count(), 0);
+}
+
+TEST_F(ActionLoaderTest, PreloadFollowsTheChain)
+{
+  ActionLoader action_loader(path);
+
+  action_loader.preload(get_name(ACTION_COUNT - 3));
+  EXPECT_EQ(action_loader.get_parsed_count(), 3);
+
+  for (int i = ACTION_COUNT - 3; i < ACTION_COUNT; ++i) {
+    auto action_data = action_loader.take(get_name(i));
+    ASSERT_TRUE(action_data);
+    EXPECT_EQ((*action_data)["name"], get_name(i));
+  }
+
+  EXPECT_EQ(action_loader.get_parsed_count(), 3);
+}
+
+TEST_F(ActionLoaderTest, TakesUnknownAndBrokenActionsAsEmpty)
+{
+  write("broken.json", "{\"name\": ");
+
+  ActionLoader action_loader(path);
+
+  EXPECT_FALSE(action_loader.take("missing"));
+  EXPECT_FALSE(action_loader.take("broken"));
+
+  action_loader.preload("broken");
+  EXPECT_FALSE(action_loader.take("broken"));
+}
+
+TEST_F(ActionLoaderTest, ParsesEachActionOnceWhileRacing)
+{
+  for (int round = 0; round < 200; ++round) {
+    ActionLoader action_loader(path);
+
+    std::vector<std::string> priority;
+    if (round % 2 == 0) {
+      priority.push_back(get_name(ACTION_COUNT - 1));
+    }
+
+    action_loader.prefetch(priority);
+
+    std::thread preloader([&]() {
+        action_loader.preload(get_name(round % ACTION_COUNT));
+      });
+
+    // two threads take every other action, so a name is never taken twice
+    std::vector<int> failures(2, 0);
+    std::vector<std::thread> takers;
+    for (int t = 0; t < 2; ++t) {
+      takers.emplace_back(
+        [&, t]() {
+          for (int i = t; i < ACTION_COUNT; i += 2) {
+            int index = (round % 3 == 0) ? ACTION_COUNT - 1 - i : i;
+            auto action_data = action_loader.take(get_name(index));
+            if (!action_data || (*action_data)["name"] != get_name(index)) {
+              ++failures[t];
+            }
+          }
+        });
+    }
+
+    preloader.join();
+    for (auto & taker : takers) {
+      taker.join();
+    }
+
+    ASSERT_EQ(failures[0] + failures[1], 0) << "round " << round;
+    ASSERT_EQ(action_loader.get_parsed_count(), ACTION_COUNT) << "round " << round;
+  }
+}
+
+}  // namespace
@@ -0,0 +1,125 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "akushon/action/node/action_manager.hpp"
+#include "nlohmann/json.hpp"
+
+namespace
+{
+
+using akushon::ActionManager;
+
+akushon::Action make_action(ActionManager & action_manager, const std::string & name, float target)
+{
+  nlohmann::json pose_data;
+  pose_data["name"] = "pose";
+  pose_data["speed"] = 0.1;
+  pose_data["pause"] = 0.0;
+  pose_data["joints"]["neck_yaw"] = target;
+
+  nlohmann::json action_data;
+  action_data["name"] = name;
+  action_data["next"] = "";
+  action_data["start_delay"] = 0;
+  action_data["stop_delay"] = 0;
+  action_data["poses"].push_back(pose_data);
+
+  return action_manager.load_action(action_data, name);
+}
+
+TEST(ActionManagerTest, EditsDoNotReachSharedLibrary)
+{
+  ActionManager first;
+  first.insert_action("a", make_action(first, "a", 10.0));
+  first.insert_action("b", make_action(first, "b", 20.0));
+
+  ActionManager second;
+  second.share_library(first);
+  EXPECT_EQ(second.get_library(), first.get_library());
+
+  auto library = first.get_library();
+
+  second.insert_action("c", make_action(second, "c", 30.0));
+  second.delete_action("a");
+
+  EXPECT_NE(second.get_library(), library);
+  EXPECT_EQ(first.get_library(), library);
+
+  EXPECT_EQ(first.get_action_id("c"), -1);
+  EXPECT_GE(first.get_action_id("a"), 0);
+  EXPECT_EQ(first.get_action("a").get_pose_count(), 1);
+
+  EXPECT_GE(second.get_action_id("c"), 0);
+  EXPECT_EQ(second.get_action_id("a"), -1);
+  EXPECT_EQ(second.get_action("b").get_pose_count(), 1);
+}
+
+TEST(ActionManagerTest, InsertKeepsExistingAction)
+{
+  ActionManager action_manager;
+  action_manager.insert_action("a", make_action(action_manager, "a", 10.0));
+  action_manager.insert_action("a", make_action(action_manager, "a", 20.0));
+
+  EXPECT_FLOAT_EQ(
+    action_manager.get_action("a").get_pose(0).get_joints().front().get_position(), 10.0);
+}
+
+TEST(ActionManagerTest, ReinsertedActionGetsItsIdBack)
+{
+  ActionManager action_manager;
+  action_manager.insert_action("a", make_action(action_manager, "a", 10.0));
+  action_manager.insert_action("b", make_action(action_manager, "b", 20.0));
+
+  int a_id = action_manager.get_action_id("a");
+  int b_id = action_manager.get_action_id("b");
+
+  action_manager.delete_action("a");
+  EXPECT_EQ(action_manager.get_action_id("a"), -1);
+  EXPECT_EQ(action_manager.get_action_id("b"), b_id);
+
+  action_manager.insert_action("a", make_action(action_manager, "a", 15.0));
+  EXPECT_EQ(action_manager.get_action_id("a"), a_id);
+  EXPECT_EQ(action_manager.get_action_id("b"), b_id);
+
+  EXPECT_FLOAT_EQ(
+    action_manager.get_action("a").get_pose(0).get_joints().front().get_position(), 15.0);
+}
+
+TEST(ActionManagerTest, RepeatedEditsKeepTheArenaCompact)
+{
+  ActionManager action_manager;
+  action_manager.insert_action("a", make_action(action_manager, "a", 0.0));
+
+  auto first_status = action_manager.get_library()->get_memory_status();
+  for (int i = 1; i <= 100; ++i) {
+    action_manager.delete_action("a");
+    action_manager.insert_action("a", make_action(action_manager, "a", i));
+  }
+
+  auto last_status = action_manager.get_library()->get_memory_status();
+  EXPECT_GT(last_status.generation, first_status.generation);
+  EXPECT_LE(last_status.used_bytes, first_status.used_bytes * 2);
+}
+
+}  // namespace
@@ -0,0 +1,173 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "akushon/action/model/action_transform.hpp"
+#include "akushon/action/node/action_manager.hpp"
+#include "akushon/action/process/interpolator.hpp"
+#include "tachimawari/joint/model/joint.hpp"
+#include "tachimawari/joint/model/joint_id.hpp"
+
+namespace
+{
+
+using akushon::ActionTransform;
+using tachimawari::joint::JointId;
+
+int id_of(const std::string & joint_name)
+{
+  return JointId::by_name.at(joint_name);
+}
+
+std::vector<float> make_positions()
+{
+  std::vector<float> positions(ActionTransform::MAX_JOINTS);
+  for (size_t id = 0; id < positions.size(); ++id) {
+    positions[id] = 10.0 + id;
+  }
+
+  return positions;
+}
+
+TEST(ActionTransformTest, KeepsPositionsByDefault)
+{
+  ActionTransform transform;
+  auto positions = make_positions();
+
+  for (const auto & [joint_name, joint_id] : JointId::by_name) {
+    EXPECT_EQ(transform.get_source_id(joint_id), joint_id) << joint_name;
+    EXPECT_FLOAT_EQ(transform.get_position(joint_id, positions.data()), positions[joint_id]);
+  }
+}
+
+TEST(ActionTransformTest, MirrorSwapsSidesWithSign)
+{
+  ActionTransform transform;
+  transform.set_mirror(true);
+  auto positions = make_positions();
+
+  int left_knee = id_of("left_knee");
+  int right_knee = id_of("right_knee");
+  EXPECT_EQ(transform.get_source_id(left_knee), right_knee);
+  EXPECT_EQ(transform.get_source_id(right_knee), left_knee);
+  EXPECT_FLOAT_EQ(transform.get_position(left_knee, positions.data()), -positions[right_knee]);
+  EXPECT_FLOAT_EQ(transform.get_position(right_knee, positions.data()), -positions[left_knee]);
+
+  int neck_yaw = id_of("neck_yaw");
+  EXPECT_EQ(transform.get_source_id(neck_yaw), neck_yaw);
+  EXPECT_FLOAT_EQ(transform.get_position(neck_yaw, positions.data()), -positions[neck_yaw]);
+
+  int neck_pitch = id_of("neck_pitch");
+  EXPECT_EQ(transform.get_source_id(neck_pitch), neck_pitch);
+  EXPECT_FLOAT_EQ(transform.get_position(neck_pitch, positions.data()), positions[neck_pitch]);
+}
+
+TEST(ActionTransformTest, MirrorTwiceRestoresPositions)
+{
+  ActionTransform transform;
+  transform.set_mirror(true);
+  auto positions = make_positions();
+
+  std::vector<float> mirrored(positions.size());
+  for (size_t id = 0; id < positions.size(); ++id) {
+    mirrored[id] = transform.get_position(id, positions.data());
+  }
+
+  for (size_t id = 0; id < positions.size(); ++id) {
+    EXPECT_FLOAT_EQ(transform.get_position(id, mirrored.data()), positions[id]) << id;
+  }
+
+  transform.set_mirror(false);
+  for (size_t id = 0; id < positions.size(); ++id) {
+    EXPECT_EQ(transform.get_source_id(id), static_cast<int>(id));
+  }
+}
+
+TEST(ActionTransformTest, OffsetIsAddedAfterMirroring)
+{
+  ActionTransform transform;
+  transform.set_mirror(true);
+  auto positions = make_positions();
+
+  int left_elbow = id_of("left_elbow");
+  int right_elbow = id_of("right_elbow");
+  transform.set_offset(left_elbow, 5.0);
+
+  EXPECT_FLOAT_EQ(
+    transform.get_position(left_elbow, positions.data()), -positions[right_elbow] + 5.0);
+  EXPECT_FLOAT_EQ(
+    transform.get_position(right_elbow, positions.data()), -positions[left_elbow]);
+}
+
+TEST(ActionTransformTest, MirroredPlaybackEndsOnMirroredPose)
+{
+  nlohmann::json action_data;
+  action_data["name"] = "kick";
+  action_data["next"] = "";
+  action_data["start_delay"] = 0;
+  action_data["stop_delay"] = 0;
+
+  nlohmann::json pose_data;
+  pose_data["name"] = "lift";
+  pose_data["speed"] = 0.1;
+  pose_data["pause"] = 0.0;
+  pose_data["joints"]["left_knee"] = 40.0;
+  pose_data["joints"]["right_knee"] = -10.0;
+  pose_data["joints"]["neck_yaw"] = 15.0;
+  action_data["poses"].push_back(pose_data);
+
+  akushon::ActionManager action_manager;
+  action_manager.insert_action("kick", action_manager.load_action(action_data, "kick"));
+
+  akushon::Pose initial_pose("initial");
+  std::vector<tachimawari::joint::Joint> joints;
+  for (const auto & [joint_name, joint_id] : JointId::by_name) {
+    joints.push_back(tachimawari::joint::Joint(joint_id, 0.0));
+  }
+  initial_pose.set_joints(joints);
+
+  ActionTransform transform;
+  transform.set_mirror(true);
+
+  akushon::Interpolator interpolator(
+    action_manager.get_library(), {action_manager.get_action_id("kick")}, initial_pose,
+    transform);
+  for (int time = 0; time < 10000 && !interpolator.is_finished(); time += 8) {
+    interpolator.process(time);
+  }
+
+  ASSERT_TRUE(interpolator.is_finished());
+
+  for (const auto & joint : interpolator.get_joints()) {
+    if (joint.get_id() == id_of("left_knee")) {
+      EXPECT_NEAR(joint.get_position(), 10.0, 1e-3);
+    } else if (joint.get_id() == id_of("right_knee")) {
+      EXPECT_NEAR(joint.get_position(), -40.0, 1e-3);
+    } else if (joint.get_id() == id_of("neck_yaw")) {
+      EXPECT_NEAR(joint.get_position(), -15.0, 1e-3);
+    }
+  }
+}
+
+}  // namespace
@@ -0,0 +1,235 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "akushon/action/node/action_manager.hpp"
+#include "akushon/action/process/duration_estimator.hpp"
+#include "akushon/action/process/interpolator.hpp"
+#include "tachimawari/joint/model/joint.hpp"
+#include "tachimawari/joint/model/joint_id.hpp"
+
+namespace
+{
+
+using akushon::ActionLibrary;
+using akushon::DurationEstimator;
+using tachimawari::joint::JointId;
+
+constexpr int TIME_STEP = 8;
+
+// the interpolator runs from the clock of the node, which is far from zero
+// by the time an action starts
+constexpr int START_TIME = 800000;
+
+int play(std::shared_ptr<const ActionLibrary> library, int action_id, const akushon::Pose & pose)
+{
+  akushon::Interpolator interpolator(library, {action_id}, pose);
+
+  int time = 0;
+  while (time < 1000000) {
+    interpolator.process(START_TIME + time);
+    if (interpolator.is_finished()) {
+      break;
+    }
+
+    time += TIME_STEP;
+  }
+
+  return time;
+}
+
+akushon::Pose make_initial_pose(std::mt19937 & random)
+{
+  std::uniform_int_distribution<int> position(-60, 60);
+
+  std::vector<tachimawari::joint::Joint> joints;
+  for (const auto & [joint_name, joint_id] : JointId::by_name) {
+    joints.push_back(tachimawari::joint::Joint(joint_id, position(random)));
+  }
+
+  akushon::Pose pose("initial");
+  pose.set_joints(joints);
+
+  return pose;
+}
+
+akushon::Pose make_resting_pose()
+{
+  std::vector<tachimawari::joint::Joint> joints;
+  for (const auto & [joint_name, joint_id] : JointId::by_name) {
+    joints.push_back(tachimawari::joint::Joint(joint_id, 0.0));
+  }
+
+  akushon::Pose pose("initial");
+  pose.set_joints(joints);
+
+  return pose;
+}
+
+nlohmann::json make_action_data(const std::vector<nlohmann::json> & poses)
+{
+  nlohmann::json action_data;
+  action_data["name"] = "test";
+  action_data["next"] = "";
+  action_data["start_delay"] = 0;
+  action_data["stop_delay"] = 0;
+  action_data["poses"] = poses;
+
+  return action_data;
+}
+
+class DurationEstimatorTest : public ::testing::Test
+{
+protected:
+  // insert_action() keeps an action that is already there
+  int insert(const nlohmann::json & action_data)
+  {
+    action_manager.delete_action("test");
+    action_manager.insert_action("test", action_manager.load_action(action_data, "test"));
+    return action_manager.get_action_id("test");
+  }
+
+  void expect_playback(int action_id, const akushon::Pose & pose)
+  {
+    auto library = action_manager.get_library();
+    DurationEstimator duration_estimator(library, TIME_STEP);
+
+    EXPECT_EQ(duration_estimator.estimate(action_id, pose), play(library, action_id, pose));
+  }
+
+  akushon::ActionManager action_manager;
+};
+
+TEST_F(DurationEstimatorTest, MatchesPlaybackOfSpeedPoses)
+{
+  std::vector<nlohmann::json> poses;
+  for (float target : {30.0, -45.0, 10.0}) {
+    nlohmann::json pose_data;
+    pose_data["name"] = "pose";
+    pose_data["speed"] = 0.05;
+    pose_data["pause"] = 0.1;
+    pose_data["joints"]["neck_yaw"] = target;
+    pose_data["joints"]["left_knee"] = target / 2;
+    poses.push_back(pose_data);
+  }
+
+  int action_id = insert(make_action_data(poses));
+
+  std::mt19937 random(1);
+  expect_playback(action_id, make_initial_pose(random));
+}
+
+TEST_F(DurationEstimatorTest, MatchesPlaybackThroughViaPoints)
+{
+  auto make_poses = [](float via) {
+      std::vector<nlohmann::json> poses;
+      for (float target : {30.0, 60.0, 20.0, 0.0}) {
+        nlohmann::json pose_data;
+        pose_data["name"] = "pose";
+        pose_data["speed"] = 0.05;
+        pose_data["pause"] = 0.0;
+        pose_data["via"] = via;
+        pose_data["joints"]["neck_yaw"] = target;
+        pose_data["joints"]["neck_pitch"] = target / 2;
+        poses.push_back(pose_data);
+      }
+
+      return poses;
+    };
+
+  auto pose = make_resting_pose();
+
+  int stop_id = insert(make_action_data(make_poses(0.0)));
+  int stop_duration = DurationEstimator(action_manager.get_library()).estimate(stop_id, pose);
+  expect_playback(stop_id, pose);
+
+  int via_id = insert(make_action_data(make_poses(5.0)));
+  int via_duration = DurationEstimator(action_manager.get_library()).estimate(via_id, pose);
+  expect_playback(via_id, pose);
+
+  // blending into the next pose skips the slow arrival of every pose
+  EXPECT_LT(via_duration, stop_duration);
+}
+
+TEST_F(DurationEstimatorTest, MatchesPlaybackOfRandomActions)
+{
+  std::mt19937 random(7);
+  std::uniform_int_distribution<int> position(-60, 60);
+
+  for (int round = 0; round < 100; ++round) {
+    auto pose = make_initial_pose(random);
+
+    std::vector<nlohmann::json> poses;
+    int pose_count = 2 + random() % 5;
+    for (int i = 0; i < pose_count; ++i) {
+      nlohmann::json pose_data;
+      pose_data["name"] = "pose_" + std::to_string(i);
+      pose_data["speed"] = 0.02 + (random() % 20) / 100.0;
+      pose_data["pause"] = (random() % 4 == 0) ? 0.1 : 0.0;
+      if (random() % 4 != 0) {
+        pose_data["via"] = 0.5 + (random() % 80) / 10.0;
+      }
+
+      if (random() % 6 == 0) {
+        pose_data["duration_ms"] = 100 + random() % 400;
+      }
+
+      for (const auto & [joint_name, joint_id] : JointId::by_name) {
+        if (random() % 3 != 0) {
+          pose_data["joints"][joint_name] = position(random);
+        }
+      }
+
+      poses.push_back(pose_data);
+    }
+
+    auto action_data = make_action_data(poses);
+    int action_id = insert(action_data);
+
+    SCOPED_TRACE(action_data.dump());
+    expect_playback(action_id, pose);
+  }
+}
+
+TEST_F(DurationEstimatorTest, DetectsLoopingChain)
+{
+  nlohmann::json pose_data;
+  pose_data["name"] = "pose";
+  pose_data["speed"] = 0.1;
+  pose_data["pause"] = 0.0;
+  pose_data["joints"]["neck_yaw"] = 10.0;
+
+  auto action_data = make_action_data({pose_data});
+  action_data["next"] = "test";
+  int action_id = insert(action_data);
+
+  DurationEstimator duration_estimator(action_manager.get_library());
+  EXPECT_GT(duration_estimator.estimate(action_id), 0);
+  EXPECT_LT(duration_estimator.estimate_chain(action_id), 0);
+}
+
+}  // namespace
@@ -0,0 +1,137 @@
+// Copyright (c) 2021-2023 Ichiro ITS
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "akushon/action/utils/input_log.hpp"
+#include "tachimawari/joint/model/joint.hpp"
+
+namespace
+{
+
+using akushon::InputLog;
+
+class InputLogTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    const auto * test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+    path = std::filesystem::temp_directory_path() /
+      ("akushon_" + std::string(test_info->name()) + "_" + std::to_string(getpid()) + ".log");
+
+    std::vector<tachimawari::joint::Joint> joints = {
+      tachimawari::joint::Joint(1, 10.0), tachimawari::joint::Joint(19, -5.5)};
+
+    InputLog input_log(path);
+    ASSERT_TRUE(input_log.is_open());
+
+    input_log.write_current_joints(joints);
+    input_log.write_tick(8, {});
+    input_log.write_action(InputLog::RUN_ACTION, 1, "walk_ready", "");
+    input_log.write_tick(16, joints);
+    input_log.write_brake_action();
+    input_log.write_action(InputLog::ENQUEUE_ACTION, 2, "kick", "{\"name\": \"kick\"}");
+  }
+
+  void TearDown() override
+  {
+    std::filesystem::remove(path);
+  }
+
+  std::filesystem::path path;
+};
+
+TEST_F(InputLogTest, LoadsWrittenEvents)
+{
+  auto events = InputLog::load(path);
+  ASSERT_EQ(events.size(), 6);
+
+  EXPECT_EQ(events[0].type, InputLog::CURRENT_JOINTS);
+  ASSERT_EQ(events[0].joints.size(), 2);
+  EXPECT_EQ(events[0].joints[1].get_id(), 19);
+  EXPECT_FLOAT_EQ(events[0].joints[1].get_position(), -5.5);
+
+  EXPECT_EQ(events[1].type, InputLog::TICK);
+  EXPECT_EQ(events[1].time, 8);
+  EXPECT_EQ(events[1].output_hash, 0);
+
+  EXPECT_EQ(events[2].type, InputLog::RUN_ACTION);
+  EXPECT_EQ(events[2].control_type, 1);
+  EXPECT_EQ(events[2].action_name, "walk_ready");
+
+  EXPECT_EQ(events[3].type, InputLog::TICK);
+  EXPECT_EQ(events[3].output_hash, InputLog::hash(events[0].joints));
+
+  EXPECT_EQ(events[4].type, InputLog::BRAKE_ACTION);
+
+  EXPECT_EQ(events[5].type, InputLog::ENQUEUE_ACTION);
+  EXPECT_EQ(events[5].control_type, 2);
+  EXPECT_EQ(events[5].action_name, "kick");
+  EXPECT_EQ(events[5].json, "{\"name\": \"kick\"}");
+
+  for (size_t i = 1; i < events.size(); ++i) {
+    EXPECT_GE(events[i].timestamp, events[i - 1].timestamp);
+  }
+}
+
+TEST_F(InputLogTest, LoadsWholeEventsOfTruncatedLog)
+{
+  auto events = InputLog::load(path);
+  auto size = std::filesystem::file_size(path);
+
+  // cut the log at every byte, as a crash could, and expect the events
+  // before the cut back
+  size_t previous_count = 0;
+  for (auto cut = size; cut-- > 0; ) {
+    std::filesystem::resize_file(path, cut);
+
+    auto truncated_events = InputLog::load(path);
+    ASSERT_LT(truncated_events.size(), events.size()) << "cut at " << cut;
+    if (cut + 1 < size) {
+      ASSERT_LE(truncated_events.size(), previous_count) << "cut at " << cut;
+    }
+
+    for (size_t i = 0; i < truncated_events.size(); ++i) {
+      EXPECT_EQ(truncated_events[i].type, events[i].type);
+      EXPECT_EQ(truncated_events[i].timestamp, events[i].timestamp);
+      EXPECT_EQ(truncated_events[i].action_name, events[i].action_name);
+      EXPECT_EQ(truncated_events[i].json, events[i].json);
+    }
+
+    previous_count = truncated_events.size();
+  }
+
+  EXPECT_EQ(previous_count, 0);
+}
+
+TEST_F(InputLogTest, LoadsNothingFromMissingFile)
+{
+  std::filesystem::remove(path);
+
+  EXPECT_TRUE(InputLog::load(path).empty());
+}
+
+}  // namespace